@@ -0,0 +1,43 @@
+#include "allocation.h"
+
+#include <new>
+#include <cstdlib>
+
+namespace
+{
+	// Every allocation is prefixed with its size, so that unsized deletes can be accounted for as well
+	constexpr std::size_t allocationHeader = alignof(std::max_align_t);
+}
+
+std::atomic<std::size_t> liveBytes = 0;
+std::atomic<std::size_t> liveAllocations = 0;
+std::atomic<std::size_t> totalAllocations = 0;
+
+void* operator new(std::size_t size)
+{
+	auto* block = static_cast<unsigned char*>(std::malloc(size + allocationHeader));
+	if (!block)
+		throw std::bad_alloc();
+
+	*reinterpret_cast<std::size_t*>(block) = size;
+	liveBytes.fetch_add(size, std::memory_order_relaxed);
+	liveAllocations.fetch_add(1, std::memory_order_relaxed);
+	totalAllocations.fetch_add(1, std::memory_order_relaxed);
+	return block + allocationHeader;
+}
+
+void operator delete(void* pointer) noexcept
+{
+	if (!pointer)
+		return;
+
+	auto* block = static_cast<unsigned char*>(pointer) - allocationHeader;
+	liveBytes.fetch_sub(*reinterpret_cast<std::size_t*>(block), std::memory_order_relaxed);
+	liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+	std::free(block);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	operator delete(pointer);
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Counters kept by the replacement operator new and delete. These are defined in allocation.cpp, a
+// translation unit of their own, so that the compiler cannot inline them into the frees of the
+// standard library and warn about the header arithmetic it sees there.
+extern std::atomic<std::size_t> liveBytes;
+extern std::atomic<std::size_t> liveAllocations;
+extern std::atomic<std::size_t> totalAllocations;
@@ -1,9 +1,123 @@
 #include <benchmark/benchmark.h>
 #include <reflection/reflectable.h>
+#include <reflection/library.h>
+#include <reflection/event_bus.h>
+#include <reflection/serializer.h>
+#include <reflection/json.h>
+#include <reflection/snapshot.h>
+#include <reflection/pool.h>
+#include <reflection/thread_pool.h>
+#include <reflection/declaration.h>
+
+#include "allocation.h"
+
+#include <new>
+#include <array>
+#include <cmath>
+#include <deque>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory_resource>
+#include <utility>
 
 using namespace benchmark;
 using namespace lh::reflection;
 
+/* Allocation Tracking */
+
+// Reports the heap allocations per iteration of the benchmark loop that follows it as a counter, so
+// that allocation regressions show up in the JSON results next to the timings
+class AllocationCounter
+{
+public:
+	explicit AllocationCounter(State& state) :
+		_state(state),
+		_start(totalAllocations.load())
+	{
+	}
+
+	~AllocationCounter()
+	{
+		const auto allocations = totalAllocations.load() - _start;
+		_state.counters["allocations"] = static_cast<double>(allocations) / static_cast<double>(std::max<IterationCount>(_state.iterations(), 1));
+	}
+
+private:
+	State& _state;
+	std::size_t _start;
+};
+
+/* Baselines */
+
+struct Accumulator
+{
+	virtual ~Accumulator() = default;
+	virtual void add(int value) = 0;
+};
+
+struct Sum final : Accumulator
+{
+	int count = 0;
+
+	void add(int value) override { count += value; }
+};
+
+void baseline_direct_call(State& state)
+{
+	Sum sum;
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+	{
+		sum.add(5);
+		DoNotOptimize(sum.count);
+	}
+}
+
+void baseline_virtual_call(State& state)
+{
+	Sum sum;
+	Accumulator* accumulator = &sum;
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+	{
+		// Hides the dynamic type, so that the call cannot be devirtualized
+		DoNotOptimize(accumulator);
+		accumulator->add(5);
+	}
+}
+
+void baseline_std_function(State& state)
+{
+	int count = 0;
+	std::function<void(int)> add = [&count](int value) { count += value; };
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+	{
+		add(5);
+		DoNotOptimize(count);
+	}
+}
+
+void baseline_new(State& state)
+{
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+	{
+		auto sum = new Sum();
+		DoNotOptimize(sum);
+		delete sum;
+	}
+}
+
+/* Benchmarks */
+
 void reflectable_invoke_mutable(State& state)
 {
 	Reflectable testee;
@@ -18,6 +132,7 @@ void reflectable_invoke_mutable(State& state)
 		}), Method::Qualifier::Mutable);
 	}
 
+	const AllocationCounter allocations(state);
 	for (auto _ : state)
 		testee.invoke("increment", 5);
 }
@@ -36,6 +151,7 @@ void reflectable_invoke_immutable(State& state)
 		}), Method::Qualifier::Immutable);
 	}
 
+	const AllocationCounter allocations(state);
 	for (auto _ : state)
 		bool result = testee.invoke<bool>("compare", 42);
 }
@@ -54,34 +170,1727 @@ void reflectable_invoke_static(State& state)
 		}));
 	}
 
+	const AllocationCounter allocations(state);
 	for (auto _ : state)
 		mo.method("static_compare").invoke<bool>(42);
 }
 
-void reflectable_event(State& state)
+// Probing for a method that may be missing: by catching the exception (0), by hasMethod before
+// invoking (1) or with tryInvoke (2)
+void reflectable_probe(State& state, const char* name)
+{
+	Reflectable testee;
+	auto& mo = const_cast<MetaObject&>(testee.metaObject());
+
+	if (!mo.hasMethod("probed"))
+		mo.addMethod("probed", [](Reflectable*, int value) -> int { return value; }, Method::Qualifier::Mutable);
+
+	const AllocationCounter allocations(state);
+	switch (state.range(0))
+	{
+	case 0:
+		for (auto _ : state)
+		{
+			try
+			{
+				DoNotOptimize(testee.invoke<int>(name, 5));
+			}
+			catch (const unknown_method&)
+			{
+			}
+		}
+		break;
+	case 1:
+		for (auto _ : state)
+			if (mo.hasMethod(name))
+				DoNotOptimize(testee.invoke<int>(name, 5));
+		break;
+	default:
+		for (auto _ : state)
+			DoNotOptimize(testee.tryInvoke<int>(name, 5).hasValue());
+		break;
+	}
+}
+
+void reflectable_probe_hit(State& state)
+{
+	reflectable_probe(state, "probed");
+}
+
+void reflectable_probe_miss(State& state)
+{
+	reflectable_probe(state, "not_probed");
+}
+
+void method_handle_invoke_mutable(State& state)
+{
+	Reflectable testee;
+	auto& mo = const_cast<MetaObject&>(testee.metaObject());
+
+	int count = 0;
+
+	if (!mo.hasMethod("handle_increment"))
+	{
+		mo.addMethod("handle_increment", std::function([&count](Reflectable*, int value) -> void {
+			count += value;
+		}), Method::Qualifier::Mutable);
+	}
+
+	auto handle = mo.methodHandle<void, int>("handle_increment", Method::Qualifier::Mutable);
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+		handle.invoke(&testee, 5);
+}
+
+void method_handle_invoke_immutable(State& state)
 {
 	Reflectable testee;
 	auto& mo = const_cast<MetaObject&>(testee.metaObject());
 
 	int count = 42;
 
-	if (!mo.hasEvent("test"))
+	if (!mo.hasMethod("handle_compare"))
 	{
-		mo.addEvent<int>("test");
+		mo.addMethod("handle_compare", std::function([&count](Reflectable*, int value) -> bool {
+			return count == value;
+		}), Method::Qualifier::Immutable);
 	}
 
-	testee.subscribe("test", std::function([&count](int value) -> void {
-		if (value == count)
-			++count;
-	}));
+	auto handle = mo.methodHandle<bool, int>("handle_compare", Method::Qualifier::Immutable);
 
+	const AllocationCounter allocations(state);
 	for (auto _ : state)
-		testee.event("test", count);
+		DoNotOptimize(handle.invoke(&testee, 42));
+}
+
+void method_handle_invoke_static(State& state)
+{
+	Reflectable testee;
+	auto& mo = const_cast<MetaObject&>(testee.metaObject());
+
+	int count = 42;
+
+	if (!mo.hasMethod("handle_static_compare"))
+	{
+		mo.addMethod("handle_static_compare", std::function([&count](int value) -> bool {
+			return count == value;
+		}));
+	}
+
+	auto handle = mo.methodHandle<bool, int>("handle_static_compare");
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+		DoNotOptimize(handle.invoke(42));
+}
+
+void property_handle_get(State& state)
+{
+	Reflectable testee;
+	auto& mo = const_cast<MetaObject&>(testee.metaObject());
+
+	int count = 42;
+
+	if (!mo.hasProperty("handle_count"))
+	{
+		mo.addProperty("handle_count",
+			std::function([&count](const Reflectable*) -> int {
+				return count;
+			}),
+			std::function([&count](Reflectable*, int value) -> void {
+				count = value;
+			})
+		);
+	}
+
+	auto handle = mo.propertyHandle<int>("handle_count");
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+		DoNotOptimize(handle.get(&testee));
+}
+
+struct Sample : Reflectable
+{
+	int value = 0;
+};
+
+const Property& sampleProperty()
+{
+	auto& mo = const_cast<MetaObject&>(Reflectable::staticMetaObject());
+
+	if (!mo.hasProperty("sample_value"))
+	{
+		mo.addProperty("sample_value",
+			[](const Sample* sample) -> int { return sample->value; },
+			[](Sample* sample, int value) { sample->value = value; });
+	}
+
+	return mo.property("sample_value");
+}
+
+void reflectable_property_get(State& state)
+{
+	sampleProperty();
+	Sample sample;
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+		DoNotOptimize(sample.get<int>("sample_value"));
+}
+
+void reflectable_property_set(State& state)
+{
+	sampleProperty();
+	Sample sample;
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+	{
+		sample.set("sample_value", 42);
+		DoNotOptimize(sample.value);
+	}
+}
+
+const Property& sampleField()
+{
+	auto& mo = const_cast<MetaObject&>(Reflectable::staticMetaObject());
+
+	if (!mo.hasProperty("sample_field"))
+		mo.addProperty("sample_field", &Sample::value);
+
+	return mo.property("sample_field");
+}
+
+void property_get(State& state, const Property& property)
+{
+	Sample sample;
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+	{
+		DoNotOptimize(&sample);
+		DoNotOptimize(property.get<Sample, int>(&sample));
+	}
+}
+
+void property_get_accessor(State& state)
+{
+	property_get(state, sampleProperty());
+}
+
+void property_get_field(State& state)
+{
+	property_get(state, sampleField());
+}
+
+void property_set(State& state, const Property& property)
+{
+	Sample sample;
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+	{
+		property.set(&sample, 42);
+		DoNotOptimize(sample.value);
+	}
+}
+
+void property_set_accessor(State& state)
+{
+	property_set(state, sampleProperty());
+}
+
+void property_set_field(State& state)
+{
+	property_set(state, sampleField());
+}
+
+void property_handle_set(State& state)
+{
+	sampleProperty();
+	Sample sample;
+	const auto handle = Reflectable::staticMetaObject().propertyHandle<int>("sample_value");
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+	{
+		handle.set(&sample, 42);
+		DoNotOptimize(sample.value);
+	}
+}
+
+void property_get_loop(State& state)
+{
+	sampleProperty();
+	std::vector<Sample> samples(static_cast<std::size_t>(state.range(0)));
+	std::vector<int> column(samples.size());
+
+	for (auto _ : state)
+	{
+		for (std::size_t i = 0; i < samples.size(); ++i)
+			column[i] = samples[i].get<int>("sample_value");
+
+		DoNotOptimize(column.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void property_gather_pointers(State& state)
+{
+	const auto& property = sampleProperty();
+	std::vector<Sample> samples(static_cast<std::size_t>(state.range(0)));
+	std::vector<const Reflectable*> pointers;
+	for (const auto& sample : samples)
+		pointers.push_back(&sample);
+
+	std::vector<int> column(samples.size());
+
+	for (auto _ : state)
+	{
+		property.gather<Reflectable, int>(pointers, column);
+		DoNotOptimize(column.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void property_gather_contiguous(State& state, const Property& property)
+{
+	std::vector<Sample> samples(static_cast<std::size_t>(state.range(0)));
+	std::vector<int> column(samples.size());
+
+	for (auto _ : state)
+	{
+		property.gather<Sample, int>(std::span<const Sample>(samples), column);
+		DoNotOptimize(column.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void property_gather_contiguous(State& state)
+{
+	property_gather_contiguous(state, sampleProperty());
+}
+
+void property_gather_field(State& state)
+{
+	property_gather_contiguous(state, sampleField());
+}
+
+void property_scatter_contiguous(State& state)
+{
+	const auto& property = sampleProperty();
+	std::vector<Sample> samples(static_cast<std::size_t>(state.range(0)));
+	const std::vector<int> column(samples.size(), 42);
+
+	for (auto _ : state)
+	{
+		property.scatter<Sample, int>(std::span<Sample>(samples), column);
+		DoNotOptimize(samples.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Large payloads registered by value and by reference, to compare the copies made per access
+struct Document : Reflectable
+{
+	std::string text;
+	std::vector<double> samples;
+
+	const MetaObject& metaObject() const noexcept override;
+};
+
+const MetaObject& Document::metaObject() const noexcept
+{
+	static MetaObject mo = [] {
+		MetaObject mo("Document", typeid(Document));
+		mo.addProperty("text_value", [](const Document* d) { return d->text; }, [](Document* d, std::string v) { d->text = std::move(v); });
+		mo.addProperty("text", [](const Document* d) -> const std::string& { return d->text; }, [](Document* d, std::string&& v) { d->text = std::move(v); });
+		mo.addProperty("samples_value", [](const Document* d) { return d->samples; }, [](Document* d, std::vector<double> v) { d->samples = std::move(v); });
+		mo.addProperty("samples", &Document::samples);
+		mo.seal();
+		return mo;
+	}();
+
+	return mo;
+}
+
+Document document(std::size_t size)
+{
+	Document document;
+	document.text.assign(size, 'x');
+	document.samples.assign(size / sizeof(double), 1.0);
+	return document;
+}
+
+template <typename T>
+void document_get(State& state, const char* name)
+{
+	const auto input = document(static_cast<std::size_t>(state.range(0)));
+	const auto& property = input.metaObject().property(name);
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+	{
+		const T value = property.get<Document, T>(&input);
+		DoNotOptimize(std::data(value));
+	}
+
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void document_get_text_value(State& state)
+{
+	document_get<std::string>(state, "text_value");
+}
+
+void document_get_text_reference(State& state)
+{
+	document_get<const std::string&>(state, "text");
+}
+
+void document_get_text_view(State& state)
+{
+	document_get<std::string_view>(state, "text");
+}
+
+void document_get_samples_value(State& state)
+{
+	document_get<std::vector<double>>(state, "samples_value");
+}
+
+void document_get_samples_span(State& state)
+{
+	document_get<std::span<const double>>(state, "samples");
+}
+
+// Hands the payload to the instance and takes it back, which only moves it around
+void document_set(State& state, const char* name)
+{
+	auto input = document(static_cast<std::size_t>(state.range(0)));
+	auto text = std::move(input.text);
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+	{
+		input.set(name, std::move(text));
+		text = std::move(input.text);
+		DoNotOptimize(text.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void document_set_text_value(State& state)
+{
+	document_set(state, "text_value");
+}
+
+void document_set_text_reference(State& state)
+{
+	document_set(state, "text");
+}
+
+struct Particle
+{
+	std::int32_t id;
+	double x, y, z;
+	std::uint64_t flags;
+};
+
+const MetaObject& particleMetaObject()
+{
+	static MetaObject mo = [] {
+		MetaObject mo("Particle", typeid(Particle));
+		mo.addProperty("id", [](const Particle* p) { return p->id; }, [](Particle* p, std::int32_t v) { p->id = v; });
+		mo.addProperty("x", [](const Particle* p) { return p->x; }, [](Particle* p, double v) { p->x = v; });
+		mo.addProperty("y", [](const Particle* p) { return p->y; }, [](Particle* p, double v) { p->y = v; });
+		mo.addProperty("z", [](const Particle* p) { return p->z; }, [](Particle* p, double v) { p->z = v; });
+		mo.addProperty("flags", [](const Particle* p) { return p->flags; }, [](Particle* p, std::uint64_t v) { p->flags = v; });
+		return mo;
+	}();
+
+	return mo;
+}
+
+const MetaObject& particleFieldMetaObject()
+{
+	static MetaObject mo = [] {
+		MetaObject mo("ParticleFields", typeid(Particle));
+		mo.addProperty("id", &Particle::id);
+		mo.addProperty("x", &Particle::x);
+		mo.addProperty("y", &Particle::y);
+		mo.addProperty("z", &Particle::z);
+		mo.addProperty("flags", &Particle::flags);
+		return mo;
+	}();
+
+	return mo;
+}
+
+std::vector<Particle> particles()
+{
+	std::vector<Particle> particles(4096);
+	for (std::size_t i = 0; i < particles.size(); ++i)
+		particles[i] = Particle{static_cast<std::int32_t>(i), 1.0 * i, 2.0 * i, 3.0 * i, i};
+
+	return particles;
+}
+
+void serialize_handwritten(State& state)
+{
+	const auto input = particles();
+	std::vector<std::byte> buffer(1 << 16);
+	constexpr std::size_t size = sizeof(std::int32_t) + 3 * sizeof(double) + sizeof(std::uint64_t);
+
+	for (auto _ : state)
+	{
+		std::size_t used = 0;
+		for (const auto& particle : input)
+		{
+			if (buffer.size() - used < size)
+			{
+				DoNotOptimize(buffer.data());
+				used = 0;
+			}
+
+			auto out = buffer.data() + used;
+			std::memcpy(out, &particle.flags, 8);
+			std::memcpy(out + 8, &particle.id, 4);
+			std::memcpy(out + 12, &particle.x, 8);
+			std::memcpy(out + 20, &particle.y, 8);
+			std::memcpy(out + 28, &particle.z, 8);
+			used += size;
+		}
+
+		DoNotOptimize(buffer.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * input.size() * size);
+}
+
+void serialize_plan(State& state, const MetaObject& metaObject)
+{
+	const auto input = particles();
+	std::vector<std::byte> buffer(1 << 16);
+	Serializer serializer(metaObject);
+
+	std::size_t bytes = 0;
+	for (auto _ : state)
+		bytes += serializer.encode(std::span<const Particle>(input), std::span(buffer), [](std::span<const std::byte> part) { DoNotOptimize(part.data()); });
+
+	state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+}
+
+void deserialize_plan(State& state, const MetaObject& metaObject)
+{
+	const auto input = particles();
+	Serializer serializer(metaObject);
+
+	std::vector<std::byte> buffer(input.size() * serializer.fixedSize());
+	serializer.encode(std::span<const Particle>(input), std::span(buffer), [](std::span<const std::byte>) {});
+
+	std::vector<Particle> output(input.size());
+	for (auto _ : state)
+	{
+		std::span<const std::byte> in(buffer);
+		for (auto& particle : output)
+			in = in.subspan(serializer.decode(&particle, in));
+
+		DoNotOptimize(output.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+void serialize_plan(State& state)
+{
+	serialize_plan(state, particleMetaObject());
+}
+
+void serialize_plan_fields(State& state)
+{
+	serialize_plan(state, particleFieldMetaObject());
+}
+
+void deserialize_plan(State& state)
+{
+	deserialize_plan(state, particleMetaObject());
+}
+
+void deserialize_plan_fields(State& state)
+{
+	deserialize_plan(state, particleFieldMetaObject());
+}
+
+struct Endpoint
+{
+	std::int32_t port = 0;
+	double weight = 0;
+	bool secure = false;
+	std::string host;
+};
+
+const MetaObject& endpointMetaObject()
+{
+	static MetaObject mo = [] {
+		MetaObject mo("Endpoint", typeid(Endpoint));
+		mo.addProperty("port", [](const Endpoint* e) { return e->port; }, [](Endpoint* e, std::int32_t v) { e->port = v; });
+		mo.addProperty("weight", [](const Endpoint* e) { return e->weight; }, [](Endpoint* e, double v) { e->weight = v; });
+		mo.addProperty("secure", [](const Endpoint* e) { return e->secure; }, [](Endpoint* e, bool v) { e->secure = v; });
+		mo.addProperty("host", [](const Endpoint* e) { return e->host; }, [](Endpoint* e, std::string v) { e->host = std::move(v); });
+		return mo;
+	}();
+
+	return mo;
+}
+
+std::string endpointsJson(const JsonCodec& codec)
+{
+	std::vector<Endpoint> endpoints(1000);
+	for (std::size_t i = 0; i < endpoints.size(); ++i)
+		endpoints[i] = Endpoint{static_cast<std::int32_t>(i), i * 0.125, i % 2 == 0, "node" + std::to_string(i) + ".example.org"};
+
+	std::string json;
+	codec.writeArray(std::span<const Endpoint>(endpoints), json);
+	return json;
+}
+
+void json_read(State& state)
+{
+	JsonCodec codec(endpointMetaObject());
+	const auto json = endpointsJson(codec);
+
+	for (auto _ : state)
+	{
+		std::int64_t ports = 0;
+		codec.readArray<Endpoint>(json, [&ports](Endpoint&& endpoint) { ports += endpoint.port; });
+		DoNotOptimize(ports);
+	}
+
+	state.SetBytesProcessed(state.iterations() * json.size());
+}
+
+void json_write(State& state)
+{
+	JsonCodec codec(endpointMetaObject());
+	const auto json = endpointsJson(codec);
+
+	std::vector<Endpoint> endpoints;
+	codec.readArray<Endpoint>(json, [&endpoints](Endpoint&& endpoint) { endpoints.push_back(std::move(endpoint)); });
+
+	std::string out;
+	for (auto _ : state)
+	{
+		out.clear();
+		codec.writeArray(std::span<const Endpoint>(endpoints), out);
+		DoNotOptimize(out.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * json.size());
+}
+
+void reflectable_invoke_inline(State& state)
+{
+	Reflectable testee;
+	auto& mo = const_cast<MetaObject&>(testee.metaObject());
+
+	int count = 0;
+
+	if (!mo.hasMethod("inline_increment"))
+	{
+		mo.addMethod("inline_increment", [&count](Reflectable*, int value) -> void {
+			count += value;
+		}, Method::Qualifier::Mutable);
+	}
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+		testee.invoke("inline_increment", 5);
+}
+
+void method_handle_invoke_inline(State& state)
+{
+	Reflectable testee;
+	auto& mo = const_cast<MetaObject&>(testee.metaObject());
+
+	int count = 0;
+
+	if (!mo.hasMethod("inline_handle_increment"))
+	{
+		mo.addMethod("inline_handle_increment", [&count](Reflectable*, int value) -> void {
+			count += value;
+		}, Method::Qualifier::Mutable);
+	}
+
+	auto handle = mo.methodHandle<void, int>("inline_handle_increment", Method::Qualifier::Mutable);
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+		handle.invoke(&testee, 5);
+}
+
+// Argument 0 leaves metrics disabled, otherwise they are enabled and every nth call is timed. Only
+// differs from method_handle_invoke_inline when built with REFLECTION_METRICS.
+void method_handle_invoke_metrics(State& state)
+{
+	Reflectable testee;
+	auto& mo = const_cast<MetaObject&>(testee.metaObject());
+
+	int count = 0;
+
+	if (!mo.hasMethod("measured_increment"))
+	{
+		mo.addMethod("measured_increment", [&count](Reflectable*, int value) -> void {
+			count += value;
+		}, Method::Qualifier::Mutable);
+	}
+
+	auto handle = mo.methodHandle<void, int>("measured_increment", Method::Qualifier::Mutable);
+
+	Metrics::enable(state.range(0) != 0);
+	Metrics::sample(static_cast<std::uint32_t>(state.range(0)));
+
+	for (auto _ : state)
+		handle.invoke(&testee, 5);
+
+	Metrics::enable(false);
+	Metrics::sample(0);
+}
+
+// Arguments known only at runtime, as from a scripting language or an RPC message
+void method_invoke_dynamic(State& state)
+{
+	Reflectable testee;
+	auto& mo = const_cast<MetaObject&>(testee.metaObject());
+
+	if (!mo.hasMethod("dynamic_scale"))
+	{
+		mo.addMethod("dynamic_scale", [](Reflectable*, int value, double factor) -> double {
+			return value * factor;
+		}, Method::Qualifier::Mutable);
+	}
+
+	const auto& method = mo.method("dynamic_scale");
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+	{
+		ArgumentFrame arguments(2);
+		arguments[0] = 21;
+		arguments[1] = 1.5;
+		DoNotOptimize(method.invokeDynamic(&testee, arguments, Method::Qualifier::Mutable).get<double>());
+	}
+}
+
+// Reference parameters are not found by the hash lookup but by scanning the overloads
+void method_invoke_dynamic_string(State& state)
+{
+	Reflectable testee;
+	auto& mo = const_cast<MetaObject&>(testee.metaObject());
+
+	if (!mo.hasMethod("dynamic_length"))
+	{
+		mo.addMethod("dynamic_length", [](const Reflectable*, const std::string& text) -> std::size_t {
+			return text.size();
+		}, Method::Qualifier::Immutable);
+	}
+
+	const auto& method = mo.method("dynamic_length");
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+	{
+		ArgumentFrame arguments(1);
+		arguments[0] = "short text";
+		DoNotOptimize(method.invokeDynamic(&testee, arguments, Method::Qualifier::Immutable).get<std::size_t>());
+	}
+}
+
+struct Body
+{
+	double position = 0;
+	double velocity = 1;
+
+	void step(double dt) { position += velocity * dt; }
+	double energy() const { return velocity * velocity / 2; }
+
+	// Heavy enough that a parallel loop is bound by the work and not by handing out chunks
+	void update(double dt)
+	{
+		for (int i = 0; i < 32; ++i)
+		{
+			velocity -= std::sin(position) * dt;
+			position += velocity * dt;
+		}
+	}
+};
+
+const MetaObject& bodyType()
+{
+	static MetaObject type = [] {
+		MetaObject type("Body", typeid(Body));
+		type.addMethod("step", &Body::step);
+		type.addMethod("energy", &Body::energy);
+		type.addMethod("update", &Body::update);
+		type.seal();
+		return type;
+	}();
+
+	return type;
+}
+
+constexpr std::size_t bodyCount = 10000;
+
+std::vector<Body*> bodies()
+{
+	static std::vector<Body> storage(bodyCount);
+
+	std::vector<Body*> instances;
+	for (auto& particle : storage)
+		instances.push_back(&particle);
+
+	return instances;
+}
+
+// Looks the method up again for every instance, like calling Reflectable::invoke in a loop
+void method_invoke_each(State& state)
+{
+	const auto& type = bodyType();
+	auto instances = bodies();
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+		for (auto instance : instances)
+			type.method("step").invoke<void, Body, double>(instance, 0.01, Method::Qualifier::Mutable);
+
+	state.SetItemsProcessed(state.iterations() * instances.size());
+}
+
+// Const method on non-const instances, which unsealed methods look up twice
+void method_invoke_const_each(State& state)
+{
+	const auto& type = bodyType();
+	auto instances = bodies();
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+		for (auto instance : instances)
+			DoNotOptimize(type.method("energy").invoke<double, Body>(instance, Method::Qualifier::Mutable));
+
+	state.SetItemsProcessed(state.iterations() * instances.size());
+}
+
+void method_invoke_all(State& state)
+{
+	const auto& type = bodyType();
+	auto instances = bodies();
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+		type.method("step").invokeAll(std::span(instances), 0.01);
+
+	state.SetItemsProcessed(state.iterations() * instances.size());
+}
+
+// Argument is the number of threads including the caller
+void method_invoke_all_parallel(State& state)
+{
+	const auto& type = bodyType();
+	auto instances = bodies();
+	ThreadPool pool(static_cast<std::size_t>(state.range(0)) - 1);
+
+	for (auto _ : state)
+		type.method("update").invokeAll(pool, 256, std::span(instances), 0.01);
+
+	state.SetItemsProcessed(state.iterations() * instances.size());
+}
+
+void metaobject_lookup_string_view(State& state)
+{
+	Reflectable testee;
+	auto& mo = const_cast<MetaObject&>(testee.metaObject());
+
+	const auto name = "lookup_" + std::string(state.range(0), 'x');
+
+	if (!mo.hasMethod(name))
+		mo.addMethod(name, std::function([](int value) -> int { return value; }));
+
+	const std::string_view view = name;
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+		DoNotOptimize(&mo.method(view));
+}
+
+void metaobject_lookup_symbol(State& state)
+{
+	Reflectable testee;
+	auto& mo = const_cast<MetaObject&>(testee.metaObject());
+
+	const auto name = "lookup_" + std::string(state.range(0), 'x');
+
+	if (!mo.hasMethod(name))
+		mo.addMethod(name, std::function([](int value) -> int { return value; }));
+
+	const auto symbol = Symbol::intern(name);
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+		DoNotOptimize(&mo.method(symbol));
+}
+
+void populate(MetaObject& mo, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const auto suffix = std::to_string(i);
+
+		mo.addMethod("method_" + suffix, [](Reflectable*, int value) -> int { return value; }, Method::Qualifier::Mutable);
+		mo.addMethod("method_" + suffix, [](Reflectable*, int value, int factor) -> int { return value * factor; }, Method::Qualifier::Immutable);
+		mo.addProperty("property_" + suffix, [](const Reflectable*) -> int { return 0; }, [](Reflectable*, int) {});
+		mo.addEvent<int>("event_" + suffix);
+	}
+}
+
+std::vector<Symbol> methodSymbols(std::size_t count)
+{
+	std::vector<Symbol> symbols;
+	for (std::size_t i = 0; i < count; ++i)
+		symbols.push_back(Symbol::intern("method_" + std::to_string(i)));
+
+	return symbols;
+}
+
+void metaobject_memory(State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	methodSymbols(count);
+
+	std::size_t unsealedBytes = 0, sealedBytes = 0;
+	std::size_t unsealedAllocations = 0, sealedAllocations = 0;
+
+	for (auto _ : state)
+	{
+		const auto bytes = liveBytes.load();
+		const auto allocations = liveAllocations.load();
+
+		MetaObject mo("Populated", typeid(Reflectable));
+		populate(mo, count);
+		unsealedBytes = liveBytes.load() - bytes;
+		unsealedAllocations = liveAllocations.load() - allocations;
+
+		mo.seal();
+		sealedBytes = liveBytes.load() - bytes;
+		sealedAllocations = liveAllocations.load() - allocations;
+	}
+
+	state.counters["bytes_unsealed"] = static_cast<double>(unsealedBytes);
+	state.counters["bytes_sealed"] = static_cast<double>(sealedBytes);
+	state.counters["allocations_unsealed"] = static_cast<double>(unsealedAllocations);
+	state.counters["allocations_sealed"] = static_cast<double>(sealedAllocations);
+}
+
+// Footprint per type of a registry of synthetic types, as reported by memoryUsage and as measured by
+// the allocation tracking. The measured bytes include the MetaObjects themselves, which memoryUsage
+// leaves to whoever owns them.
+void metaobject_memory_usage(State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	std::array<char, 64> payload{};
+
+	MemoryUsage usage;
+	std::size_t measured = 0;
+
+	for (auto _ : state)
+	{
+		const auto bytes = liveBytes.load();
+
+		std::deque<MetaObject> types;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			auto& mo = types.emplace_back("Synthetic" + std::to_string(i), typeid(Reflectable));
+			populate(mo, 2);
+			mo.addMethod("captured", [payload](const Reflectable*) -> int { return payload[0]; }, Method::Qualifier::Immutable);
+			mo.seal();
+		}
+
+		measured = liveBytes.load() - bytes;
+
+		usage = MemoryUsage();
+		for (const auto& mo : types)
+			usage += mo.memoryUsage();
+	}
+
+	const auto perType = [count](std::size_t bytes) { return static_cast<double>(bytes) / static_cast<double>(count); };
+	state.counters["names"] = perType(usage.names);
+	state.counters["tables"] = perType(usage.tables);
+	state.counters["overloads"] = perType(usage.overloads);
+	state.counters["argument_types"] = perType(usage.argumentTypes);
+	state.counters["captures"] = perType(usage.captures);
+	state.counters["total"] = perType(usage.total());
+	state.counters["object"] = static_cast<double>(sizeof(MetaObject));
+	state.counters["measured"] = perType(measured);
+}
+
+void metaobject_lookup(State& state, bool seal)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto symbols = methodSymbols(count);
+
+	MetaObject mo("Populated", typeid(Reflectable));
+	populate(mo, count);
+
+	if (seal)
+		mo.seal();
+
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		DoNotOptimize(&mo.method(symbols[i]).overload(utility::signatureHash<int>(), Method::Qualifier::Mutable));
+		i = i + 1 == count ? 0 : i + 1;
+	}
+}
+
+template <std::size_t... Is>
+void addOverloads(MetaObject& mo, std::size_t count, std::index_sequence<Is...>)
+{
+	((Is < count ? mo.addMethod("overloaded", [](std::integral_constant<std::size_t, Is>) -> std::size_t { return Is; }) : void()), ...);
+}
+
+// Typed call of one method with a growing number of overloads
+void method_overload_lookup(State& state)
+{
+	MetaObject mo("Overloaded", typeid(Reflectable));
+	addOverloads(mo, static_cast<std::size_t>(state.range(0)), std::make_index_sequence<256>());
+	mo.seal();
+
+	const auto& method = mo.method("overloaded");
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+		DoNotOptimize(method.invoke<std::size_t>(std::integral_constant<std::size_t, 0>()));
+}
+
+void metaobject_lookup_unsealed(State& state)
+{
+	metaobject_lookup(state, false);
+}
+
+void metaobject_lookup_sealed(State& state)
+{
+	metaobject_lookup(state, true);
+}
+
+// A chain of eight types where every fourth level also has a mixin base; the query is the root, reached
+// through first bases, or the topmost mixin, reached through another base
+void metaobject_is_subtype(State& state)
+{
+	std::deque<MetaObject> chain;
+	std::deque<MetaObject> mixins;
+
+	chain.emplace_back("Level0", typeid(Reflectable));
+	for (int i = 1; i < 8; ++i)
+	{
+		std::vector<const MetaObject*> bases = {&chain.back()};
+		if (i % 4 == 0)
+			bases.push_back(&mixins.emplace_back("Mixin" + std::to_string(i), typeid(Reflectable)));
+
+		chain.emplace_back("Level" + std::to_string(i), typeid(Reflectable), bases);
+	}
+
+	const auto& query = state.range(0) ? mixins.front() : chain.front();
+	const auto* type = &chain.back();
+
+	for (auto _ : state)
+	{
+		DoNotOptimize(type);
+		DoNotOptimize(type->isSubtypeOf(query));
+	}
+}
+
+// Methods declared by the root of a sealed chain of four types, looked up through the leaf
+void metaobject_lookup_inherited(State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto symbols = methodSymbols(count);
+
+	std::deque<MetaObject> chain;
+	populate(chain.emplace_back("Inherited0", typeid(Reflectable)), count);
+	chain.back().seal();
+
+	for (int i = 1; i < 4; ++i)
+	{
+		chain.emplace_back("Inherited" + std::to_string(i), typeid(Reflectable), std::vector<const MetaObject*>{&chain.back()});
+		chain.back().seal();
+	}
+
+	const auto& leaf = chain.back();
+
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		DoNotOptimize(&leaf.method(symbols[i]).overload(utility::signatureHash<int>(), Method::Qualifier::Mutable));
+		i = i + 1 == count ? 0 : i + 1;
+	}
+}
+
+std::deque<MetaObject>& registeredTypes(std::size_t count)
+{
+	static std::deque<MetaObject> types;
+
+	while (types.size() < count)
+	{
+		auto& type = types.emplace_back("RegisteredType" + std::to_string(types.size()), typeid(Reflectable));
+		Library::global().add(&type);
+		Library::thread().add(&type);
+	}
+
+	return types;
+}
+
+void library_lookup(State& state, Library& library)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto& types = registeredTypes(count);
+
+	std::vector<std::string> names;
+	for (std::size_t i = 0; i < count; ++i)
+		names.push_back(types[i].name());
+
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		DoNotOptimize(&library.metaObject(names[i]));
+		i = i + 1 == count ? 0 : i + 1;
+	}
+}
+
+void library_lookup_dynamic(State& state)
+{
+	library_lookup(state, Library::thread());
+}
+
+void library_lookup_finalized(State& state)
+{
+	registeredTypes(static_cast<std::size_t>(state.range(0)));
+	Library::global().finalize();
+
+	library_lookup(state, Library::global());
+}
+
+/* Declared Types */
+
+struct DeclaredBody : Reflectable
+{
+	int id = 0;
+	double mass = 0;
+
+	void push(double force) { mass += force; }
+	double momentum() const { return mass; }
+};
+
+constexpr std::size_t declaredCount = 10000;
+
+constexpr MemberDeclaration declaredBodyMembers[] = {
+	declare::constructor<DeclaredBody>(),
+	declare::method<&DeclaredBody::push>("push"),
+	declare::method<&DeclaredBody::momentum>("momentum"),
+	declare::property<&DeclaredBody::id>("id"),
+	declare::property<&DeclaredBody::mass>("mass"),
+	declare::event<int>("moved")};
+
+// Synthetic types "Declared0" to "Declared9999" sharing one C++ type and one member table
+constexpr auto declaredNames = [] {
+	std::array<std::array<char, 16>, declaredCount> names{};
+
+	for (std::size_t i = 0; i < declaredCount; ++i)
+	{
+		std::size_t length = 0;
+		for (char c : std::string_view("Declared"))
+			names[i][length++] = c;
+
+		char digits[8] = {};
+		std::size_t count = 0;
+		for (auto value = i; count == 0 || value; value /= 10)
+			digits[count++] = static_cast<char>('0' + value % 10);
+
+		while (count)
+			names[i][length++] = digits[--count];
+	}
+
+	return names;
+}();
+
+constexpr auto declaredTypes = [] {
+	std::array<TypeDeclaration, declaredCount> types{};
+	for (std::size_t i = 0; i < declaredCount; ++i)
+		types[i] = TypeDeclaration{std::string_view(declaredNames[i].data()), &typeid(DeclaredBody), declaredBodyMembers};
+
+	return types;
+}();
+
+constexpr auto declaredPointers = [] {
+	std::array<const TypeDeclaration*, declaredCount> pointers{};
+	for (std::size_t i = 0; i < declaredCount; ++i)
+		pointers[i] = &declaredTypes[i];
+
+	return pointers;
+}();
+
+// Builds a synthetic type with the members of DeclaredBody, for types registered by name
+std::unique_ptr<MetaObject> buildBody(std::string_view name, const Library&)
+{
+	auto type = std::make_unique<MetaObject>(std::string(name), typeid(DeclaredBody));
+	for (const auto& member : declaredBodyMembers)
+		member.define(*type, member.name);
+
+	type->seal();
+	return type;
+}
+
+enum class Registration
+{
+	Imperative,
+	Declared,
+	Lazy
+};
+
+// Registering all types at startup, on a fresh thread for a fresh thread library: building their
+// MetaObjects eagerly, as registration code does, entering their declarations, or entering their names
+// and builders
+void library_register(State& state, Registration registration)
+{
+	for (auto _ : state)
+	{
+		std::vector<std::unique_ptr<MetaObject>> types;
+
+		std::thread([&] {
+			auto& library = Library::thread();
+			const auto start = std::chrono::steady_clock::now();
+
+			switch (registration)
+			{
+			case Registration::Imperative:
+				for (const auto& declaration : declaredTypes)
+					library.add(types.emplace_back(declaration.materialize({})).get());
+				break;
+			case Registration::Declared:
+				library.add(declaredPointers);
+				break;
+			case Registration::Lazy:
+				for (const auto& declaration : declaredTypes)
+					library.add(declaration.name, &buildBody);
+				break;
+			}
+
+			state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+		}).join();
+	}
+
+	state.counters["types"] = static_cast<double>(declaredCount);
+}
+
+void library_register_imperative(State& state)
+{
+	library_register(state, Registration::Imperative);
+}
+
+void library_register_declared(State& state)
+{
+	library_register(state, Registration::Declared);
+}
+
+void library_register_lazy(State& state)
+{
+	library_register(state, Registration::Lazy);
+}
+
+// Looking up every lazily registered type once, either for the first time, which builds it (cold), or
+// after all have been built (warm)
+void library_lookup_lazy(State& state, bool warm)
+{
+	double seconds = 0;
+
+	for (auto _ : state)
+	{
+		std::thread([&] {
+			auto& library = Library::thread();
+			for (const auto& declaration : declaredTypes)
+				library.add(declaration.name, &buildBody);
+
+			if (warm)
+				for (const auto& declaration : declaredTypes)
+					DoNotOptimize(&library.metaObject(declaration.name));
+
+			const auto start = std::chrono::steady_clock::now();
+			for (const auto& declaration : declaredTypes)
+				DoNotOptimize(&library.metaObject(declaration.name));
+
+			const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			state.SetIterationTime(elapsed);
+			seconds += elapsed;
+		}).join();
+	}
+
+	state.counters["ns_per_lookup"] = seconds * 1e9 / static_cast<double>(state.iterations() * declaredCount);
+}
+
+void library_lookup_cold(State& state)
+{
+	library_lookup_lazy(state, false);
+}
+
+void library_lookup_warm(State& state)
+{
+	library_lookup_lazy(state, true);
+}
+
+struct Message
+{
+	explicit Message(std::uint64_t id) : id(id) {}
+
+	std::uint64_t id;
+	double payload[6] = {};
+};
+
+const MetaObject& messageType()
+{
+	static MetaObject type = [] {
+		MetaObject type("Message", typeid(Message));
+		type.addConstructor<Message, std::uint64_t>();
+		return type;
+	}();
+
+	return type;
+}
+
+void metaobject_instantiate(State& state)
+{
+	const auto& type = messageType();
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+		delete type.instantiate<Message>(std::uint64_t(42));
+}
+
+void library_instantiate(State& state)
+{
+	auto& library = Library::thread();
+	if (!library.exists("Message"))
+		library.add(&messageType());
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+		delete library.instantiate<Message>("Message", std::uint64_t(42));
+}
+
+// Every iteration creates a batch of messages and destroys them again, like a request handler
+constexpr std::size_t messageBatch = 1000;
+
+void instantiate_heap(State& state)
+{
+	const auto& type = messageType();
+	std::vector<Message*> messages(messageBatch);
+
+	for (auto _ : state)
+	{
+		for (std::uint64_t i = 0; i < messageBatch; ++i)
+			messages[i] = type.instantiate<Message>(i);
+
+		for (auto message : messages)
+			delete message;
+	}
+
+	state.SetItemsProcessed(state.iterations() * messageBatch);
+}
+
+void instantiate_arena(State& state)
+{
+	const auto& type = messageType();
+	utility::arena arena;
+
+	for (auto _ : state)
+	{
+		for (std::uint64_t i = 0; i < messageBatch; ++i)
+			DoNotOptimize(type.construct<Message>(arena, i));
+
+		arena.release();
+	}
+
+	state.SetItemsProcessed(state.iterations() * messageBatch);
+}
+
+void instantiate_pmr_pool(State& state)
+{
+	const auto& type = messageType();
+	std::pmr::unsynchronized_pool_resource resource;
+	std::vector<Message*> messages(messageBatch);
+
+	for (auto _ : state)
+	{
+		for (std::uint64_t i = 0; i < messageBatch; ++i)
+			messages[i] = type.construct<Message>(resource, i);
+
+		for (auto message : messages)
+			type.destroy(message, resource);
+	}
+
+	state.SetItemsProcessed(state.iterations() * messageBatch);
+}
+
+void instantiate_pool(State& state)
+{
+	Pool pool(messageType());
+	std::vector<Message*> messages(messageBatch);
+
+	for (auto _ : state)
+	{
+		for (std::uint64_t i = 0; i < messageBatch; ++i)
+			messages[i] = pool.acquire<Message>(i);
+
+		for (auto message : messages)
+			pool.recycle(message);
+	}
+
+	state.SetItemsProcessed(state.iterations() * messageBatch);
+}
+
+void snapshot_export(State& state)
+{
+	registeredTypes(static_cast<std::size_t>(state.range(0)));
+
+	for (auto _ : state)
+		DoNotOptimize(Library::thread().snapshot());
+}
+
+// Opening an image only checks its header, the cost of starting up from a mapped snapshot
+void snapshot_open(State& state)
+{
+	registeredTypes(static_cast<std::size_t>(state.range(0)));
+	const auto image = Library::thread().snapshot();
+
+	for (auto _ : state)
+	{
+		SchemaSnapshot snapshot(image);
+		DoNotOptimize(snapshot.contentHash());
+	}
+}
+
+void snapshot_lookup(State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto& types = registeredTypes(count);
+	const auto image = Library::thread().snapshot();
+	const SchemaSnapshot snapshot(image);
+
+	std::vector<std::string> names;
+	for (std::size_t i = 0; i < count; ++i)
+		names.push_back(types[i].name());
+
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		DoNotOptimize(snapshot.find(names[i]));
+		i = i + 1 == count ? 0 : i + 1;
+	}
+}
+
+// Lookups on all threads while a background thread keeps registering new types
+void library_concurrent_lookup(State& state)
+{
+	static const auto names = [] {
+		const auto& types = registeredTypes(1000);
+
+		std::vector<std::string> names;
+		for (const auto& type : types)
+			names.push_back(type.name());
+
+		return names;
+	}();
+
+	static std::atomic<bool> registering;
+	static std::thread registrar;
+
+	if (state.thread_index() == 0)
+	{
+		registering = true;
+		registrar = std::thread([] {
+			static std::deque<MetaObject> types;
+
+			while (registering)
+			{
+				auto& type = types.emplace_back("BackgroundType" + std::to_string(types.size()), typeid(Reflectable));
+				Library::global().add(&type);
+				std::this_thread::sleep_for(std::chrono::microseconds(50));
+			}
+		});
+	}
+
+	auto& library = Library::global();
+	std::size_t i = static_cast<std::size_t>(state.thread_index()) * 97 % names.size();
+	for (auto _ : state)
+	{
+		DoNotOptimize(&library.metaObject(names[i]));
+		i = i + 1 == names.size() ? 0 : i + 1;
+	}
+
+	if (state.thread_index() == 0)
+	{
+		registering = false;
+		registrar.join();
+	}
+}
+
+// Lookups on all threads without concurrent registrations
+void library_global_lookup(State& state)
+{
+	static const auto names = [] {
+		const auto& types = registeredTypes(1000);
+
+		std::vector<std::string> names;
+		for (const auto& type : types)
+			names.push_back(type.name());
+
+		return names;
+	}();
+
+	auto& library = Library::global();
+	std::size_t i = static_cast<std::size_t>(state.thread_index()) * 97 % names.size();
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+	{
+		DoNotOptimize(&library.metaObject(names[i]));
+		i = i + 1 == names.size() ? 0 : i + 1;
+	}
+}
+
+void reflectable_event(State& state)
+{
+	Reflectable testee;
+	auto& mo = const_cast<MetaObject&>(testee.metaObject());
+
+	int count = 42;
+
+	if (!mo.hasEvent("test"))
+	{
+		mo.addEvent<int>("test");
+	}
+
+	testee.subscribe("test", std::function([&count](int value) -> void {
+		if (value == count)
+			++count;
+	}));
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+		testee.event("test", count);
+}
+
+void reflectable_event_handle(State& state)
+{
+	Reflectable testee;
+	auto& mo = const_cast<MetaObject&>(testee.metaObject());
+
+	int count = 42;
+
+	if (!mo.hasEvent("test"))
+		mo.addEvent<int>("test");
+
+	testee.subscribe("test", std::function([&count](int value) -> void {
+		if (value == count)
+			++count;
+	}));
+
+	const auto handle = mo.eventHandle<int>("test");
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+		testee.event(handle, count);
+}
+
+void reflectable_event_unsubscribed(State& state)
+{
+	Reflectable testee;
+	auto& mo = const_cast<MetaObject&>(testee.metaObject());
+
+	if (!mo.hasEvent("test"))
+		mo.addEvent<int>("test");
+
+	const auto handle = mo.eventHandle<int>("test");
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+	{
+		testee.event(handle, 42);
+		ClobberMemory();
+	}
+}
+
+// Emitter-side cost of one event, the handler runs on one of range(0) workers
+// One emit delivered synchronously to a growing number of subscribers
+void reflectable_event_fanout(State& state)
+{
+	Reflectable testee;
+	auto& mo = const_cast<MetaObject&>(testee.metaObject());
+
+	if (!mo.hasEvent("fanout"))
+		mo.addEvent<int>("fanout");
+
+	int received = 0;
+	for (std::int64_t i = 0; i < state.range(0); ++i)
+		testee.subscribe("fanout", [&received](int value) { received += value; });
+
+	const auto handle = mo.eventHandle<int>("fanout");
+
+	const AllocationCounter allocations(state);
+	for (auto _ : state)
+	{
+		testee.event(handle, 1);
+		DoNotOptimize(received);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void event_async_emit(State& state)
+{
+	EventBus bus(static_cast<std::size_t>(state.range(0)));
+
+	Reflectable testee;
+	auto& mo = const_cast<MetaObject&>(testee.metaObject());
+
+	if (!mo.hasEvent("test"))
+		mo.addEvent<int>("test");
+
+	testee.setEventBus(&bus);
+
+	std::atomic<int> received = 0;
+	for (int i = 0; i < state.range(0); ++i)
+		testee.subscribe("test", [&received](int value) { received.fetch_add(value, std::memory_order_relaxed); });
+
+	for (auto _ : state)
+		testee.event("test", 1);
+
+	bus.flush();
+}
+
+// Events delivered per second, including the time until all handlers have run
+void event_async_throughput(State& state)
+{
+	constexpr int batch = 1000;
+
+	EventBus bus(static_cast<std::size_t>(state.range(0)), 4096);
+
+	Reflectable testee;
+	auto& mo = const_cast<MetaObject&>(testee.metaObject());
+
+	if (!mo.hasEvent("test"))
+		mo.addEvent<int>("test");
+
+	testee.setEventBus(&bus);
+
+	std::atomic<int> received = 0;
+	for (int i = 0; i < state.range(0); ++i)
+		testee.subscribe("test", [&received](int value) { received.fetch_add(value, std::memory_order_relaxed); });
+
+	for (auto _ : state)
+	{
+		for (int i = 0; i < batch; ++i)
+			testee.event("test", 1);
+
+		bus.flush();
+	}
+
+	state.SetItemsProcessed(state.iterations() * batch * state.range(0));
 }
 
+BENCHMARK(baseline_direct_call);
+BENCHMARK(baseline_virtual_call);
+BENCHMARK(baseline_std_function);
+BENCHMARK(baseline_new);
 BENCHMARK(reflectable_invoke_mutable);
 BENCHMARK(reflectable_invoke_immutable);
 BENCHMARK(reflectable_invoke_static);
+BENCHMARK(reflectable_probe_hit)->DenseRange(0, 2);
+BENCHMARK(reflectable_probe_miss)->DenseRange(0, 2);
+BENCHMARK(method_handle_invoke_mutable);
+BENCHMARK(method_handle_invoke_immutable);
+BENCHMARK(method_handle_invoke_static);
+BENCHMARK(property_handle_get);
+BENCHMARK(property_handle_set);
+BENCHMARK(reflectable_property_get);
+BENCHMARK(reflectable_property_set);
+BENCHMARK(property_get_accessor);
+BENCHMARK(property_get_field);
+BENCHMARK(property_set_accessor);
+BENCHMARK(property_set_field);
+BENCHMARK(property_get_loop)->Range(1 << 10, 1 << 18);
+BENCHMARK(property_gather_pointers)->Range(1 << 10, 1 << 18);
+BENCHMARK(property_gather_contiguous)->Range(1 << 10, 1 << 18);
+BENCHMARK(property_gather_field)->Range(1 << 10, 1 << 18);
+BENCHMARK(property_scatter_contiguous)->Range(1 << 10, 1 << 18);
+BENCHMARK(document_get_text_value)->RangeMultiplier(16)->Range(64, 1 << 16);
+BENCHMARK(document_get_text_reference)->RangeMultiplier(16)->Range(64, 1 << 16);
+BENCHMARK(document_get_text_view)->RangeMultiplier(16)->Range(64, 1 << 16);
+BENCHMARK(document_get_samples_value)->RangeMultiplier(16)->Range(64, 1 << 16);
+BENCHMARK(document_get_samples_span)->RangeMultiplier(16)->Range(64, 1 << 16);
+BENCHMARK(document_set_text_value)->RangeMultiplier(16)->Range(64, 1 << 16);
+BENCHMARK(document_set_text_reference)->RangeMultiplier(16)->Range(64, 1 << 16);
+BENCHMARK(serialize_handwritten);
+BENCHMARK(serialize_plan);
+BENCHMARK(serialize_plan_fields);
+BENCHMARK(deserialize_plan);
+BENCHMARK(deserialize_plan_fields);
+BENCHMARK(json_read);
+BENCHMARK(json_write);
+BENCHMARK(reflectable_invoke_inline);
+BENCHMARK(method_handle_invoke_inline);
+BENCHMARK(method_handle_invoke_metrics)->Arg(0)->Arg(1)->Arg(64);
+BENCHMARK(method_invoke_dynamic);
+BENCHMARK(method_invoke_dynamic_string);
+BENCHMARK(method_invoke_each);
+BENCHMARK(method_invoke_const_each);
+BENCHMARK(method_invoke_all);
+BENCHMARK(method_invoke_all_parallel)->DenseRange(1, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))->UseRealTime();
+BENCHMARK(metaobject_lookup_string_view)->RangeMultiplier(4)->Range(8, 512);
+BENCHMARK(metaobject_lookup_symbol)->RangeMultiplier(4)->Range(8, 512);
+BENCHMARK(metaobject_memory)->RangeMultiplier(10)->Range(10, 10000)->Iterations(1);
+BENCHMARK(metaobject_memory_usage)->Arg(10000)->Iterations(1)->Unit(kMillisecond);
+BENCHMARK(metaobject_lookup_unsealed)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK(metaobject_lookup_sealed)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK(metaobject_lookup_inherited)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK(method_overload_lookup)->RangeMultiplier(4)->Range(1, 256);
+BENCHMARK(metaobject_is_subtype)->Arg(0)->Arg(1);
+BENCHMARK(library_lookup_dynamic)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK(library_lookup_finalized)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK(metaobject_instantiate);
+BENCHMARK(library_instantiate);
+BENCHMARK(library_register_imperative)->UseManualTime()->Unit(kMillisecond);
+BENCHMARK(library_register_declared)->UseManualTime()->Unit(kMillisecond);
+BENCHMARK(library_register_lazy)->UseManualTime()->Unit(kMillisecond);
+BENCHMARK(library_lookup_cold)->UseManualTime()->Unit(kMillisecond);
+BENCHMARK(library_lookup_warm)->UseManualTime()->Unit(kMillisecond);
+BENCHMARK(instantiate_heap);
+BENCHMARK(instantiate_arena);
+BENCHMARK(instantiate_pmr_pool);
+BENCHMARK(instantiate_pool);
+BENCHMARK(snapshot_export)->Arg(100000)->Unit(kMillisecond);
+BENCHMARK(snapshot_open)->Arg(100000);
+BENCHMARK(snapshot_lookup)->RangeMultiplier(10)->Range(100, 100000);
+BENCHMARK(library_global_lookup)->ThreadRange(1, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))->UseRealTime();
+BENCHMARK(library_concurrent_lookup)->ThreadRange(1, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))->UseRealTime();
 BENCHMARK(reflectable_event);
+BENCHMARK(reflectable_event_handle);
+BENCHMARK(reflectable_event_unsubscribed);
+BENCHMARK(reflectable_event_fanout)->Arg(0)->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(event_async_emit)->Arg(1)->Arg(2)->Arg(4);
+BENCHMARK(event_async_throughput)->Arg(1)->Arg(2)->Arg(4);
 
 BENCHMARK_MAIN();
\ No newline at end of file
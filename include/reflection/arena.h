@@ -0,0 +1,121 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <type_traits>
+
+#include "reflection/utility.h"
+
+namespace lh::reflection::utility
+{
+    // Monotonic memory resource for request-scoped objects. Allocating bumps a pointer through blocks
+    // taken from the upstream resource, deallocating does nothing. Objects adopted by the arena have
+    // their destructors run on release, newest first, so releasing frees everything at once. The last
+    // block is kept across releases, which makes a reused arena allocation free in steady state.
+    class arena final : public std::pmr::memory_resource, private non_copyable
+    {
+    public:
+        using destroy_t = void (*)(void *object) noexcept;
+
+        explicit arena(std::size_t blockSize = 4096, std::pmr::memory_resource *upstream = std::pmr::get_default_resource()) noexcept :
+            _blockSize(blockSize),
+            _upstream(upstream)
+        {
+        }
+
+        ~arena() override;
+
+        // Hides memory_resource::allocate so that callers knowing the arena skip the virtual call
+        void *allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t))
+        {
+            const auto address = (reinterpret_cast<std::uintptr_t>(_current) + alignment - 1) & ~(alignment - 1);
+            if (address + bytes > reinterpret_cast<std::uintptr_t>(_end))
+                return grow(bytes, alignment);
+
+            _current = reinterpret_cast<std::byte *>(address + bytes);
+            return reinterpret_cast<void *>(address);
+        }
+
+        // Runs destroy on the object when the arena is released
+        void adopt(void *object, destroy_t destroy);
+
+        template <typename T>
+        void adopt(T *object)
+        {
+            if constexpr (!std::is_trivially_destructible_v<T>)
+                adopt(const_cast<void *>(static_cast<const void *>(object)), [](void *object) noexcept { std::destroy_at(static_cast<T *>(object)); });
+        }
+
+        // Position of the next allocation and the newest adopted object, see rewind
+        struct marker
+        {
+            const void *block;
+            std::byte *current;
+            const void *finalizers;
+        };
+
+        marker mark() const noexcept { return {_block, _current, _finalizers}; }
+
+        // Destroys the objects adopted since the marker was taken and makes the memory allocated since
+        // available again, for scoped allocations given back in reverse order. A marker taken before the
+        // first block rewinds to its start. Other blocks grown in the meantime stay in use until the next
+        // release.
+        void rewind(const marker &position) noexcept
+        {
+            finalize(static_cast<const Finalizer *>(position.finalizers));
+
+            if (position.block == _block)
+                _current = position.current;
+            else if (!position.block && _block && !_block->previous)
+                _current = reinterpret_cast<std::byte *>(_block + 1);
+        }
+
+        // Destroys all adopted objects and makes all memory available again
+        void release() noexcept;
+
+        std::size_t allocated() const noexcept;
+
+    private:
+        struct Block
+        {
+            Block *previous;
+            std::size_t size;
+        };
+
+        struct Finalizer
+        {
+            Finalizer *next;
+            void *object;
+            destroy_t destroy;
+        };
+
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override { return allocate(bytes, alignment); }
+        void do_deallocate(void *, std::size_t, std::size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+        void *grow(std::size_t bytes, std::size_t alignment);
+
+        // Destroys the objects adopted after until, newest first
+        void finalize(const Finalizer *until = nullptr) noexcept
+        {
+            while (_finalizers != until)
+            {
+                auto finalizer = std::exchange(_finalizers, _finalizers->next);
+                finalizer->destroy(finalizer->object);
+            }
+        }
+
+        std::size_t _blockSize;
+        std::pmr::memory_resource *_upstream;
+
+        Block *_block = nullptr;
+        std::byte *_current = nullptr;
+        std::byte *_end = nullptr;
+        std::size_t _retired = 0;
+
+        Finalizer *_finalizers = nullptr;
+    };
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <new>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+
+#include "reflection/utility.h"
+
+namespace lh::reflection::utility
+{
+    // Bounded lock-free queue after Vyukov: every cell carries a sequence number that tells producers and
+    // consumers whether it is free or filled for their lap, so both sides only contend on one counter each.
+    // Safe for any number of producers and consumers; the capacity is rounded up to a power of two.
+    template <typename T>
+    class bounded_queue : private non_copyable
+    {
+    public:
+        explicit bounded_queue(std::size_t capacity)
+        {
+            std::size_t size = 2;
+            while (size < capacity)
+                size <<= 1;
+
+            _mask = size - 1;
+            _cells = std::make_unique<cell[]>(size);
+            for (std::size_t i = 0; i < size; ++i)
+                _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        std::size_t capacity() const noexcept { return _mask + 1; }
+
+        // Moves from value only if there was room
+        bool try_push(T &value)
+        {
+            auto position = _tail.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                auto &slot = _cells[position & _mask];
+                const auto sequence = slot.sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+
+                if (difference == 0)
+                {
+                    if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        slot.value.emplace(std::move(value));
+                        slot.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    position = _tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        std::optional<T> try_pop()
+        {
+            auto position = _head.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                auto &slot = _cells[position & _mask];
+                const auto sequence = slot.sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+
+                if (difference == 0)
+                {
+                    if (_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        std::optional<T> value(std::move(*slot.value));
+                        slot.value.reset();
+                        slot.sequence.store(position + _mask + 1, std::memory_order_release);
+                        return value;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    return std::nullopt;
+                }
+                else
+                {
+                    position = _head.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+    private:
+        static constexpr std::size_t cacheLine = 64;
+
+        struct cell
+        {
+            std::atomic<std::size_t> sequence;
+            std::optional<T> value;
+        };
+
+        std::unique_ptr<cell[]> _cells;
+        std::size_t _mask = 0;
+
+        alignas(cacheLine) std::atomic<std::size_t> _tail = 0;
+        alignas(cacheLine) std::atomic<std::size_t> _head = 0;
+    };
+}
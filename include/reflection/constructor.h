@@ -1,12 +1,12 @@
 #pragma once
 
 #include <vector>
-#include <memory>
 #include <functional>
 #include <typeindex>
 
 #include "reflection/utility.h"
 #include "reflection/function.h"
+#include "reflection/memory_usage.h"
 #include "reflection/exceptions.h"
 
 namespace lh::reflection
@@ -14,31 +14,124 @@ namespace lh::reflection
     class Constructor final : private utility::non_copyable
     {
     public:
-        template <typename R, typename... Ts>
-        explicit Constructor(std::function<R(Ts...)> fn) noexcept :
+        template <typename R, typename... Ts, typename F>
+        explicit Constructor(F fn, std::type_identity<R(Ts...)>) :
             _returnType(typeid(R)),
             _argumentTypes(utility::signature<Ts...>()),
-            _function(std::make_unique<SpecificFunction<R, Ts...>>(fn))
+            _valueSignature(utility::signatureHash<std::remove_cvref_t<Ts>...>()),
+            _signatureString(&utility::signatureString<Ts...>),
+            _function(SpecificFunction<R, Ts...>(std::move(fn))),
+            _byValue(reinterpret_cast<void (*)()>(&callByValue<R, Ts...>))
+        {
+        }
+
+        // Constructor C(Ts...) of the reflected type itself, which can also construct into given memory
+        template <typename C, typename... Ts>
+        explicit Constructor(std::type_identity<C(Ts...)>) noexcept :
+            _returnType(typeid(C *)),
+            _argumentTypes(utility::signature<Ts...>()),
+            _valueSignature(utility::signatureHash<std::remove_cvref_t<Ts>...>()),
+            _signatureString(&utility::signatureString<Ts...>),
+            _function(SpecificFunction<C *, Ts...>([](Ts... args) { return new C(std::forward<Ts>(args)...); })),
+            _byValue(reinterpret_cast<void (*)()>(&callByValue<C *, Ts...>)),
+            _place(reinterpret_cast<void (*)()>(&placeAt<C, Ts...>)),
+            _placeByValue(reinterpret_cast<void (*)()>(&placeByValue<C, Ts...>))
         {
         }
 
         std::type_index returnType() const noexcept { return _returnType; }
         std::vector<std::type_index> argumentTypes() const noexcept { return _argumentTypes; }
-        std::size_t hash() const noexcept { return _function->hash(); }
+        std::size_t hash() const noexcept { return _function.hash(); }
+
+        // Hash of the argument types with cv- and reference qualifiers removed. Arguments passed by
+        // value are matched against it when they do not match the argument types as declared.
+        std::size_t valueSignature() const noexcept { return _valueSignature; }
 
         template <typename R, typename... Ts>
         R invoke(Ts... args) const
         {
-            static const auto signatureHash = utility::signatureHash<Ts...>();
-            if (signatureHash != hash())
-                throw invalid_method_type("passed arguments " + utility::signatureString<Ts...>() + " are incompatible with constructor arguments " + utility::signatureString(argumentTypes()));
+            if (utility::signatureHash<Ts...>() == hash())
+                return _function.invoke<R>(std::forward<Ts>(args)...);
+
+            checkValues<Ts...>();
+            return invokeByValue<R>(std::remove_cvref_t<Ts>(std::forward<Ts>(args))...);
+        }
 
-            return _function->invoke<R>(args...);
+        bool placeable() const noexcept { return _place != nullptr; }
+
+        // Heap memory held by the constructor beyond its own size
+        MemoryUsage memoryUsage() const noexcept
+        {
+            MemoryUsage usage;
+            usage.argumentTypes = utility::heapSize(_argumentTypes);
+            usage.captures = _function.allocated();
+            return usage;
+        }
+
+        // Constructs into where, which has to fit an instance of the reflected type
+        template <typename R, typename... Ts>
+        R place(void *where, Ts... args) const
+        {
+            const bool exact = utility::signatureHash<Ts...>() == hash();
+            if (!exact)
+                checkValues<Ts...>();
+
+            if (!_place)
+                throw instantiation_failed("constructor (" + _signatureString() + ") is a factory and cannot construct in place");
+
+            if (exact)
+                return reinterpret_cast<R (*)(void *, Ts...)>(_place)(where, std::forward<Ts>(args)...);
+
+            return placeValues<R>(where, std::remove_cvref_t<Ts>(std::forward<Ts>(args))...);
         }
 
     private:
+        template <typename... Ts>
+        void checkValues() const
+        {
+            if (utility::signatureHash<std::remove_cvref_t<Ts>...>() != _valueSignature)
+                throw invalid_method_type("passed arguments " + utility::signatureString<Ts...>() + " are incompatible with constructor arguments " + _signatureString());
+        }
+
+        // The trampolines below take the arguments as copies owned by the caller, Ts are the argument
+        // types without cv- and reference qualifiers
+        template <typename R, typename... Ts>
+        R invokeByValue(Ts... args) const
+        {
+            return reinterpret_cast<R (*)(const GenericFunction &, Ts &...)>(_byValue)(_function, args...);
+        }
+
+        template <typename R, typename... Ts>
+        R placeValues(void *where, Ts... args) const
+        {
+            return reinterpret_cast<R (*)(void *, Ts &...)>(_placeByValue)(where, args...);
+        }
+
+        template <typename R, typename... Ts>
+        static R callByValue(const GenericFunction &function, std::remove_cvref_t<Ts> &...args)
+        {
+            return function.invoke<R, Ts...>(std::forward<Ts>(args)...);
+        }
+
+        template <typename C, typename... Ts>
+        static C *placeAt(void *where, Ts... args)
+        {
+            return ::new (where) C(std::forward<Ts>(args)...);
+        }
+
+        template <typename C, typename... Ts>
+        static C *placeByValue(void *where, std::remove_cvref_t<Ts> &...args)
+        {
+            return ::new (where) C(std::forward<Ts>(args)...);
+        }
+
         std::type_index _returnType;
         std::vector<std::type_index> _argumentTypes;
-        std::unique_ptr<GenericFunction> _function;
+        std::size_t _valueSignature;
+        std::string (*_signatureString)() noexcept;
+        GenericFunction _function;
+        void (*_byValue)();
+        void (*_place)() = nullptr;
+        void (*_placeByValue)() = nullptr;
     };
 }
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <span>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <typeinfo>
+#include <functional>
+#include <type_traits>
+
+#include "reflection/metaobject.h"
+#include "reflection/library.h"
+
+namespace lh::reflection
+{
+    // Member of a TypeDeclaration, registered on the MetaObject by define once the type is materialized
+    struct MemberDeclaration
+    {
+        using define_t = void (*)(MetaObject &type, std::string_view name);
+
+        std::string_view name;
+        define_t define;
+    };
+
+    // Type described by constant tables instead of registration code. Declarations only hold names and
+    // pointers to functions and type_info objects, so they are constant initialized into read-only data:
+    //
+    //     constexpr MemberDeclaration counterMembers[] = {
+    //         declare::constructor<Counter>(),
+    //         declare::method<&Counter::add>("add"),
+    //         declare::property<&Counter::count>("count"),
+    //         declare::event<int>("changed")};
+    //
+    //     constexpr TypeDeclaration counterType{"Counter", &typeid(Counter), counterMembers};
+    //
+    // Bases have to be declared as well, and be added to the same library.
+    struct TypeDeclaration
+    {
+        std::string_view name;
+        const std::type_info *type;
+        std::span<const MemberDeclaration> members;
+        std::span<const TypeDeclaration *const> bases = {};
+
+        // Builds the sealed MetaObject, see Library::add(const TypeDeclaration &)
+        std::unique_ptr<MetaObject> materialize(std::vector<const MetaObject *> bases) const
+        {
+            auto metaObject = std::make_unique<MetaObject>(std::string(name), *type, std::move(bases));
+
+            for (const auto &member : members)
+                member.define(*metaObject, member.name);
+
+            metaObject->seal();
+            return metaObject;
+        }
+    };
+
+    // MetaObject of a type declared with the global library, for the metaObject() overrides of
+    // Reflectable subclasses. Materializes the type on the first call.
+    template <const TypeDeclaration &Declaration>
+    const MetaObject &declared()
+    {
+        static const MetaObject &metaObject = Library::global().metaObject(Declaration.name);
+        return metaObject;
+    }
+}
+
+namespace lh::reflection::declare
+{
+    template <typename M>
+    struct member_class;
+
+    template <typename T, typename C>
+    struct member_class<T C::*>
+    {
+        using type = C;
+    };
+
+    template <auto Member>
+    using member_class_t = typename member_class<decltype(Member)>::type;
+
+    template <auto Getter>
+    using property_t = std::remove_cvref_t<std::invoke_result_t<decltype(Getter), const member_class_t<Getter> *>>;
+
+    template <typename C, typename... Ts>
+    constexpr MemberDeclaration constructor() noexcept
+    {
+        return {{}, [](MetaObject &type, std::string_view) { type.addConstructor<C, Ts...>(); }};
+    }
+
+    // Member functions become mutable or immutable overloads by their constness, functions static ones
+    template <auto Fn>
+    constexpr MemberDeclaration method(std::string_view name) noexcept
+    {
+        return {name, [](MetaObject &type, std::string_view name) { type.addMethod(std::string(name), Fn); }};
+    }
+
+    // Property backed by a getter and a setter member function, a getter returning a reference is read
+    // by reference
+    template <auto Getter, auto Setter>
+    constexpr MemberDeclaration property(std::string_view name) noexcept
+    {
+        using C = member_class_t<Getter>;
+        using T = property_t<Getter>;
+        using R = std::invoke_result_t<decltype(Getter), const C *>;
+
+        return {name, [](MetaObject &type, std::string_view name) {
+                    type.addProperty(std::string(name),
+                        [](const C *instance) -> R { return std::invoke(Getter, instance); },
+                        [](C *instance, T &&value) { std::invoke(Setter, instance, std::move(value)); });
+                }};
+    }
+
+    // Property backed by a data member
+    template <auto Member>
+        requires std::is_member_object_pointer_v<decltype(Member)>
+    constexpr MemberDeclaration property(std::string_view name) noexcept
+    {
+        return {name, [](MetaObject &type, std::string_view name) { type.addProperty(std::string(name), Member); }};
+    }
+
+    template <typename... Ts>
+    constexpr MemberDeclaration event(std::string_view name) noexcept
+    {
+        return {name, [](MetaObject &type, std::string_view name) { type.addEvent<Ts...>(std::string(name)); }};
+    }
+}
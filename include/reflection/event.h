@@ -2,46 +2,117 @@
 
 #include <string>
 #include <vector>
+#include <atomic>
+#include <memory>
 #include <functional>
 #include <typeindex>
 
 #include "reflection/utility.h"
 #include "reflection/function.h"
+#include "reflection/metrics.h"
+#include "reflection/memory_usage.h"
 #include "reflection/exceptions.h"
 
 namespace lh::reflection
 {
+    class EventBus;
+    class MetaObject;
+
+    template <typename... Ts>
+    class EventHandle;
+
     class Event final : private utility::non_copyable
     {
     public:
         class Subscription final : private utility::non_copyable
         {
             friend class Event;
+            friend class EventBus;
 
-        protected:
             template <typename... Ts>
-            explicit Subscription(std::function<void(Ts...)> fn) noexcept :
-                _handler(new SpecificFunction<void, Ts...>(fn))
+            friend class EventHandle;
+
+        protected:
+            template <typename... Ts, typename F>
+            explicit Subscription(F fn, std::type_identity<void(Ts...)>) :
+                _handler(std::make_shared<const Handler>(SpecificFunction<void, Ts...>(std::move(fn)), reinterpret_cast<void (*)()>(&Handler::template callByValue<Ts...>))),
+                _id(nextId())
             {
             }
 
             template <typename... Ts>
-            void invoke(Ts... args) const
+            void invoke(std::type_identity_t<Ts>... args) const
             {
-                _handler->invoke<void>(args...);
+                _handler->template invoke<Ts...>(std::forward<Ts>(args)...);
             }
 
         public:
-            bool operator==(const Subscription& other) const noexcept { return _handler == other._handler; }
+            bool operator==(const Subscription& other) const noexcept { return _id == other._id; }
+            std::size_t id() const noexcept { return _id; }
+
+            // Heap bytes of a handler too large to be stored inline
+            std::size_t allocated() const noexcept { return _handler->function.allocated(); }
+
+            // Heap bytes of the handler record beyond its reference counts, deliveries queued on an
+            // EventBus share it
+            static constexpr std::size_t shared() noexcept { return sizeof(Handler); }
 
         private:
-            std::unique_ptr<GenericFunction> _handler;
+            struct Handler
+            {
+                Handler(GenericFunction function, void (*byValue)()) noexcept :
+                    function(std::move(function)),
+                    byValue(byValue)
+                {
+                }
+
+                // Ts are the argument types the event is emitted with. A handler taking them with other cv-
+                // and reference qualifiers gets copies of the arguments, passed as its own argument types.
+                template <typename... Ts>
+                void invoke(std::type_identity_t<Ts>... args) const
+                {
+                    if (function.hash() == utility::signatureHash<Ts...>())
+                        function.invoke<void, Ts...>(std::forward<Ts>(args)...);
+                    else
+                        invokeByValue(std::remove_cvref_t<Ts>(args)...);
+                }
+
+                template <typename... Ts>
+                void invokeByValue(Ts... args) const
+                {
+                    reinterpret_cast<void (*)(const GenericFunction &, Ts &...)>(byValue)(function, args...);
+                }
+
+                template <typename... Ts>
+                static void callByValue(const GenericFunction &function, std::remove_cvref_t<Ts> &...args)
+                {
+                    function.invoke<void, Ts...>(std::forward<Ts>(args)...);
+                }
+
+                GenericFunction function;
+                void (*byValue)(); // callByValue for the argument types of the handler
+            };
+
+            static std::size_t nextId() noexcept
+            {
+                static std::atomic<std::size_t> id = 0;
+                return ++id;
+            }
+
+            // Shared, so that deliveries queued on an EventBus outlive unsubscribing. That costs subscribe()
+            // one allocation, which emitting and posting do not pay for.
+            std::shared_ptr<const Handler> _handler;
+            std::size_t _id;
         };
 
-        explicit Event(std::string name, std::vector<std::type_index> argumentTypes) noexcept :
+        template <typename... Ts>
+        explicit Event(std::string name, std::type_identity<void(Ts...)>, std::size_t ordinal) noexcept :
             _name(name),
-            _argumentTypes(argumentTypes),
-            _hash(utility::signatureHash(argumentTypes))
+            _argumentTypes(utility::signature<Ts...>()),
+            _hash(utility::signatureHash<Ts...>()),
+            _valueSignature(utility::signatureHash<std::remove_cvref_t<Ts>...>()),
+            _signatureString(&utility::signatureString<Ts...>),
+            _ordinal(ordinal)
         {
         }
 
@@ -49,29 +120,119 @@ namespace lh::reflection
         std::vector<std::type_index> argumentTypes() const noexcept { return _argumentTypes; }
         std::size_t hash() const noexcept { return _hash; }
 
+        // Hash of the argument types with cv- and reference qualifiers removed. Handlers and emitters
+        // are matched against it, so they may take and pass the arguments with other qualifiers.
+        std::size_t valueSignature() const noexcept { return _valueSignature; }
+
+        // Dense index of this event within its MetaObject, in registration order after the events
+        // inherited from its first base. Fixed when the event is added.
+        std::size_t ordinal() const noexcept { return _ordinal; }
+
+#ifdef REFLECTION_METRICS
+        // Counts and times emits on instances with subscriptions, not the single deliveries
+        const Metrics &metrics() const noexcept { return _metrics; }
+#endif
+
+        // Heap memory held by the event beyond its own size, without the subscriptions of instances
+        MemoryUsage memoryUsage() const noexcept
+        {
+            MemoryUsage usage;
+            usage.names = utility::heapSize(_name);
+            usage.argumentTypes = utility::heapSize(_argumentTypes);
+#ifdef REFLECTION_METRICS
+            usage.metrics = _metrics.allocated();
+#endif
+            return usage;
+        }
+
         template <typename... Ts>
-        Subscription subscribe(std::function<void(Ts...)> handler) const
+        EventHandle<Ts...> handle() const
         {
-            static const auto signatureHash = utility::signatureHash<Ts...>();
-            if (signatureHash != hash())
-                throw invalid_event_type("handler with arguments " + utility::signatureString<Ts...>() + " is incompatible with event arguments " + utility::signatureString(argumentTypes()) + " of event " + name());
+            checkArguments<Ts...>();
+            return EventHandle<Ts...>(this);
+        }
 
-            return Subscription(handler);
+        template <typename F>
+        Subscription subscribe(F handler) const
+        {
+            return subscribe(std::move(handler), utility::signature_of<F>());
         }
 
         template <typename... Ts>
         void invoke(const Subscription &subscription, Ts... args) const
         {
-            static const auto signatureHash = utility::signatureHash<Ts...>();
-            if (signatureHash != hash())
-                throw invalid_event_type("passed arguments " + utility::signatureString<Ts...>() + " are incompatible with event arguments " + utility::signatureString(argumentTypes()) + " of event " + name());
-
-            subscription.invoke(args...);
+            checkArguments<Ts...>();
+            subscription.template invoke<Ts...>(std::forward<Ts>(args)...);
         }
 
     private:
+        friend class EventBus;
+        friend class MetaObject;
+
+        template <typename... Ts>
+        void checkArguments() const
+        {
+            constexpr auto signatureHash = utility::signatureHash<std::remove_cvref_t<Ts>...>();
+            if (signatureHash != _valueSignature)
+                throw invalid_event_type("passed arguments " + utility::signatureString<Ts...>() + " are incompatible with event arguments " + _signatureString() + " of event " + name());
+        }
+
+        template <typename... Ts, typename F>
+        Subscription subscribe(F handler, std::type_identity<void(Ts...)> signature) const
+        {
+            constexpr auto signatureHash = utility::signatureHash<std::remove_cvref_t<Ts>...>();
+            if (signatureHash != _valueSignature)
+                throw invalid_event_type("handler with arguments " + utility::signatureString<Ts...>() + " is incompatible with event arguments " + _signatureString() + " of event " + name());
+
+            return Subscription(std::move(handler), signature);
+        }
+
         std::string _name;
         std::vector<std::type_index> _argumentTypes;
         std::size_t _hash;
+        std::size_t _valueSignature;
+        std::string (*_signatureString)() noexcept;
+        std::size_t _ordinal;
+#ifdef REFLECTION_METRICS
+        Metrics _metrics;
+#endif
+    };
+
+    // Event resolved and type checked up front, so emitting through it skips the name lookup and the
+    // argument check. Only valid for instances of the MetaObject it was obtained from or of types
+    // derived from it through first bases, which Reflectable::event checks against the owner.
+    // Like other handles invalidated by sealing.
+    template <typename... Ts>
+    class EventHandle final
+    {
+        friend class Event;
+        friend class MetaObject;
+
+        explicit EventHandle(const Event *event) noexcept :
+            _event(event),
+            _ordinal(event->ordinal())
+        {
+        }
+
+    public:
+        EventHandle() noexcept = default;
+
+        explicit operator bool() const noexcept { return _event != nullptr; }
+
+        const Event &event() const noexcept { return *_event; }
+        std::size_t ordinal() const noexcept { return _ordinal; }
+
+        // MetaObject the handle was obtained from, null for handles obtained from the Event itself
+        const MetaObject *owner() const noexcept { return _owner; }
+
+        void invoke(const Event::Subscription &subscription, Ts... args) const
+        {
+            subscription.template invoke<Ts...>(std::forward<Ts>(args)...);
+        }
+
+    private:
+        const Event *_event = nullptr;
+        const MetaObject *_owner = nullptr;
+        std::size_t _ordinal = 0;
     };
 }
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <new>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "reflection/event.h"
+#include "reflection/bounded_queue.h"
+
+namespace lh::reflection
+{
+    // Runs event subscriptions on a pool of worker threads. Every subscription is bound to one worker, so
+    // deliveries to the same subscription run in the order they were posted. Deliveries share the handler
+    // of their subscription, so unsubscribing leaves queued deliveries valid; what the handler captures
+    // has to outlive them, or be flushed first. Exceptions thrown by handlers are counted and dropped,
+    // they cannot reach the emitter.
+    class EventBus final : private utility::non_copyable
+    {
+    public:
+        // What post() does when the worker's queue is full
+        enum class Overflow
+        {
+            Block,
+            DropOldest,
+            DropNewest
+        };
+
+        explicit EventBus(std::size_t workers = 1, std::size_t capacity = 1024, Overflow overflow = Overflow::Block);
+        EventBus(EventBus &&) = delete;
+        ~EventBus();
+
+        // Queues one delivery, arguments are copied and passed to the subscription as the event's
+        // argument types Ts when it runs. Returns false if the delivery was dropped. Deliveries are
+        // stored inline in the queue, arguments too large for Delivery::capacity fail to compile.
+        template <typename... Ts>
+        bool post(const Event &event, const Event::Subscription &subscription, Ts... args)
+        {
+            event.checkArguments<Ts...>();
+
+            Delivery delivery([handler = subscription._handler, ... args = std::remove_cvref_t<Ts>(std::forward<Ts>(args))]() mutable {
+                handler->template invoke<Ts...>(std::forward<Ts>(args)...);
+            });
+
+            return push(*_workers[subscription.id() % _workers.size()], delivery);
+        }
+
+        // Blocks until everything posted before has run or was dropped
+        void flush();
+
+        std::size_t workers() const noexcept { return _workers.size(); }
+        std::size_t dropped() const noexcept { return _dropped.load(std::memory_order_relaxed); }
+        std::size_t failed() const noexcept { return _failed.load(std::memory_order_relaxed); }
+
+    private:
+        // Queued call with its arguments, so that posting never allocates
+        class Delivery final : private utility::non_copyable
+        {
+        public:
+            static constexpr std::size_t capacity = 96;
+
+            template <typename F>
+            explicit Delivery(F fn, bool barrier = false) noexcept :
+                _run([](void *storage) { (*static_cast<F *>(storage))(); }),
+                _manage(&manage<F>),
+                _barrier(barrier)
+            {
+                static_assert(sizeof(F) <= capacity && alignof(F) <= alignof(std::max_align_t), "event arguments do not fit into a delivery, pass large ones by pointer");
+                static_assert(std::is_nothrow_move_constructible_v<F>, "event arguments must be nothrow move constructible to be queued");
+                ::new (static_cast<void *>(_storage)) F(std::move(fn));
+            }
+
+            Delivery(Delivery &&other) noexcept :
+                _run(other._run),
+                _manage(std::exchange(other._manage, nullptr)),
+                _barrier(other._barrier)
+            {
+                if (_manage)
+                    _manage(_storage, other._storage);
+            }
+
+            ~Delivery()
+            {
+                if (_manage)
+                    _manage(_storage, nullptr);
+            }
+
+            void run() { _run(_storage); }
+            bool barrier() const noexcept { return _barrier; }
+
+        private:
+            // Moves the call from source into target, or destroys target if source is null
+            template <typename F>
+            static void manage(void *target, void *source) noexcept
+            {
+                if (source)
+                {
+                    ::new (target) F(std::move(*static_cast<F *>(source)));
+                    static_cast<F *>(source)->~F();
+                }
+                else
+                {
+                    static_cast<F *>(target)->~F();
+                }
+            }
+
+            alignas(std::max_align_t) unsigned char _storage[capacity];
+            void (*_run)(void *storage);
+            void (*_manage)(void *target, void *source) noexcept;
+            bool _barrier;
+        };
+
+        struct Worker
+        {
+            explicit Worker(std::size_t capacity) : queue(capacity) {}
+
+            utility::bounded_queue<Delivery> queue;
+            std::atomic<std::uint32_t> signal = 0;
+            std::thread thread;
+        };
+
+        bool push(Worker &worker, Delivery &delivery);
+        void run(Worker &worker);
+        void deliver(Delivery &delivery) noexcept;
+
+        std::vector<std::unique_ptr<Worker>> _workers;
+        Overflow _overflow;
+        std::atomic<bool> _stopping = false;
+        std::atomic<std::size_t> _dropped = 0;
+        std::atomic<std::size_t> _failed = 0;
+    };
+}
@@ -75,4 +75,22 @@ namespace lh::reflection
     public:
         instantiation_failed(std::string msg) : reflection_error("instantiation failed: " + msg) {}
     };
+
+    class serialization_failed : public reflection_error
+    {
+    public:
+        serialization_failed(std::string msg) : reflection_error("serialization failed: " + msg) {}
+    };
+
+    class invalid_snapshot : public reflection_error
+    {
+    public:
+        invalid_snapshot(std::string msg) : reflection_error("invalid snapshot: " + msg) {}
+    };
+
+    class invalid_value_type : public reflection_error
+    {
+    public:
+        invalid_value_type(std::string msg) : reflection_error("invalid value type: " + msg) {}
+    };
 }
@@ -1,54 +1,181 @@
 #pragma once
 
+#include <new>
+#include <cstring>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
 #include <functional>
+#include <type_traits>
 
 #include "reflection/utility.h"
 
 namespace lh::reflection
 {
+    // Type-erased callable. Function pointers, member function pointers and small function objects are
+    // stored inline next to the trampoline that calls them; larger ones fall back to a std::function.
     class GenericFunction : private utility::non_copyable
     {
-    protected:
-        explicit GenericFunction(std::size_t hash) noexcept :
-            _hash(hash)
+    public:
+        static constexpr std::size_t capacity = std::max(4 * sizeof(void *), sizeof(std::function<void()>));
+
+        template <typename R, typename... Ts>
+        using trampoline_t = R (*)(const void *, Ts...);
+
+        GenericFunction(GenericFunction &&other) noexcept
         {
+            take(other);
+        }
+
+        GenericFunction &operator=(GenericFunction &&other) noexcept
+        {
+            if (this != &other)
+            {
+                destroy();
+                take(other);
+            }
+
+            return *this;
+        }
+
+        ~GenericFunction()
+        {
+            destroy();
         }
 
-    public:
         template <typename R, typename... Ts>
-        R invoke(Ts... args) const;
+        R invoke(Ts... args) const
+        {
+            return trampoline<R, Ts...>()(_storage, std::forward<Ts>(args)...);
+        }
+
+        template <typename R, typename... Ts>
+        trampoline_t<R, Ts...> trampoline() const noexcept
+        {
+            return reinterpret_cast<trampoline_t<R, Ts...>>(_trampoline);
+        }
+
+        const void *storage() const noexcept
+        {
+            return _storage;
+        }
 
         std::size_t hash() const noexcept
         {
             return _hash;
         }
 
+        // Heap bytes taken by a callable that did not fit inline, 0 if stored inline
+        std::size_t allocated() const noexcept
+        {
+            return _allocated;
+        }
+
+    protected:
+        template <typename F>
+        static constexpr bool is_inline = sizeof(F) <= capacity && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<F>;
+
+        template <typename F, typename R, typename... Ts>
+        GenericFunction(F fn, std::type_identity<R(Ts...)>, std::size_t allocated = 0) noexcept :
+            _storage{},
+            _hash(utility::signatureHash<Ts...>()),
+            _trampoline(reinterpret_cast<void (*)()>(&call<F, R, Ts...>)),
+            _manager(std::is_trivially_copyable_v<F> ? nullptr : &manage<F>),
+            _allocated(allocated)
+        {
+            static_assert(is_inline<F>, "callable does not fit into inline storage");
+            ::new (static_cast<void *>(_storage)) F(std::move(fn));
+        }
+
     private:
+        // Moves the callable from source into target, or destroys target if source is null
+        using manager_t = void (*)(void *target, void *source) noexcept;
+
+        template <typename F, typename R, typename... Ts>
+        static R call(const void *storage, Ts... args)
+        {
+            auto &fn = *static_cast<F *>(const_cast<void *>(storage));
+
+            if constexpr (std::is_void_v<R>)
+                std::invoke(fn, std::forward<Ts>(args)...);
+            else
+                return std::invoke(fn, std::forward<Ts>(args)...);
+        }
+
+        template <typename F>
+        static void manage(void *target, void *source) noexcept
+        {
+            if (source)
+            {
+                ::new (target) F(std::move(*static_cast<F *>(source)));
+                static_cast<F *>(source)->~F();
+            }
+            else
+            {
+                static_cast<F *>(target)->~F();
+            }
+        }
+
+        // Storage is zeroed on construction, so that copying all of it never reads bytes the callable
+        // left unwritten
+        void take(GenericFunction &other) noexcept
+        {
+            _hash = other._hash;
+            _trampoline = other._trampoline;
+            _manager = std::exchange(other._manager, nullptr);
+            _allocated = other._allocated;
+
+            if (_manager)
+                _manager(_storage, other._storage);
+            else
+                std::memcpy(_storage, other._storage, capacity);
+        }
+
+        void destroy() noexcept
+        {
+            if (_manager)
+                _manager(_storage, nullptr);
+
+            _manager = nullptr;
+        }
+
+        alignas(std::max_align_t) unsigned char _storage[capacity];
         std::size_t _hash;
+        void (*_trampoline)();
+        manager_t _manager;
+        std::size_t _allocated;
     };
 
     template <typename R, typename... Ts>
     class SpecificFunction final : public GenericFunction
     {
     public:
-        explicit SpecificFunction(std::function<R(Ts...)> fn) noexcept :
-            GenericFunction(utility::signatureHash<Ts...>()),
-            _fn(fn)
+        template <typename F>
+            requires std::is_invocable_r_v<R, F &, Ts...>
+        explicit SpecificFunction(F fn) noexcept(is_inline<F>) :
+            GenericFunction(wrap(std::move(fn)), std::type_identity<R(Ts...)>(), is_inline<F> ? 0 : sizeof(F))
         {
         }
 
         R invoke(Ts... args) const
         {
-            return _fn(args...);
+            return GenericFunction::invoke<R, Ts...>(std::forward<Ts>(args)...);
         }
 
     private:
-        std::function<R(Ts...)> _fn;
-    };
+        // Falling back to std::function allocates and moves the callable, both of which may throw
+        template <typename F>
+        static auto wrap(F fn) noexcept(is_inline<F>)
+        {
+            if constexpr (is_inline<F>)
+                return fn;
+            else
+                return std::function<R(Ts...)>(std::move(fn));
+        }
 
-    template <typename R, typename... Ts>
-    R GenericFunction::invoke(Ts... args) const
-    {
-        return static_cast<const SpecificFunction<R, Ts...> *>(this)->invoke(args...);
-    }
+    public:
+        // Type a callable of type F ends up as in storage(), for callers that loop over it directly
+        template <typename F>
+        using stored_t = decltype(wrap(std::declval<F>()));
+    };
 }
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+#include "reflection/metaobject.h"
+#include "reflection/exceptions.h"
+#include "reflection/perfect_hash.h"
+
+namespace lh::reflection
+{
+    // Reads and writes the properties of a MetaObject as JSON objects. The constructor builds a perfect
+    // hash over the property names, so every key costs one hash, one slot load and one compare, and
+    // parsed values go straight into the property setters. Supports bool, sized integer, floating point
+    // and string properties; unknown keys are skipped and null leaves a property unchanged.
+    class JsonCodec final
+    {
+    public:
+        // Parser state, only defined by the implementation
+        class Reader;
+
+        explicit JsonCodec(const MetaObject &metaObject);
+
+        // Reads one object, returns the number of characters consumed
+        template <typename C>
+        std::size_t read(C *instance, std::string_view json) const
+        {
+            return readObject(static_cast<void *>(instance), json);
+        }
+
+        // Reads an array of objects one element at a time, every element is read into a default
+        // constructed C and then moved into consume. Returns the number of elements.
+        template <typename C, typename F>
+        std::size_t readArray(std::string_view json, F consume) const
+        {
+            return readElements(json, [this, &consume](Reader &reader) {
+                C instance{};
+                readObject(static_cast<void *>(&instance), reader);
+                consume(std::move(instance));
+            });
+        }
+
+        // Appends the object to out
+        template <typename C>
+        void write(const C *instance, std::string &out) const
+        {
+            writeObject(static_cast<const void *>(instance), out);
+        }
+
+        template <typename C>
+        std::string write(const C *instance) const
+        {
+            std::string out;
+            write(instance, out);
+            return out;
+        }
+
+        template <typename C>
+        void writeArray(std::span<const C> instances, std::string &out) const
+        {
+            out.push_back('[');
+
+            for (std::size_t i = 0; i < instances.size(); ++i)
+            {
+                if (i)
+                    out.push_back(',');
+
+                writeObject(static_cast<const void *>(&instances[i]), out);
+            }
+
+            out.push_back(']');
+        }
+
+    private:
+        struct Field
+        {
+            using read_t = void (*)(const Property &property, void *instance, Reader &reader);
+            using write_t = void (*)(const Property &property, const void *instance, std::string &out);
+
+            std::string name;
+            std::string prefix;
+            const Property *property;
+            read_t read;
+            write_t write;
+        };
+
+        template <typename F>
+        std::size_t readElements(std::string_view json, F element) const
+        {
+            return readElements(json, [](void *context, Reader &reader) { (*static_cast<F *>(context))(reader); }, &element);
+        }
+
+        std::size_t readElements(std::string_view json, void (*element)(void *context, Reader &reader), void *context) const;
+        std::size_t readObject(void *instance, std::string_view json) const;
+        void readObject(void *instance, Reader &reader) const;
+        void writeObject(const void *instance, std::string &out) const;
+        const Field *field(std::string_view key) const noexcept;
+
+        std::string _name;
+        std::vector<Field> _fields;
+        utility::perfect_hash _index;
+        std::vector<std::uint32_t> _slots; // indices into _fields, so that copies of the codec stay valid
+
+        static constexpr std::uint32_t empty_slot = UINT32_MAX;
+    };
+}
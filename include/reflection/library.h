@@ -1,34 +1,97 @@
 #pragma once
 
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
+#include <cstddef>
 
+#include "reflection/metrics.h"
+#include "reflection/memory_usage.h"
 #include "reflection/metaobject.h"
 
 namespace lh::reflection
 {
+    struct TypeDeclaration;
+
+    // Lookups are lock-free and may run concurrently with registrations, which are serialized
+    // internally. Registered MetaObjects must outlive the library, declared ones are owned by it.
     class Library : private utility::non_copyable
     {
         Library() noexcept;
 
     public:
+        // Builds the MetaObject of a type registered by name, see add(std::string_view, builder_t). Bases
+        // are looked up in the given library, which builds them in turn if needed.
+        using builder_t = std::unique_ptr<MetaObject> (*)(std::string_view name, const Library &library);
+
         static Library &global() noexcept;
         static Library &thread() noexcept;
 
         void add(const MetaObject *metaObject);
-        bool exists(std::string name) const noexcept;
+
+        // Registers types declared as constant tables, see TypeDeclaration. Only their names are entered;
+        // the MetaObject of a type is built the first time it is looked up, or listed by metaObjects().
+        // Declarations must outlive the library.
+        void add(const TypeDeclaration &declaration);
+        void add(std::span<const TypeDeclaration *const> declarations);
+
+        // Registers a type by name only. Its MetaObject is built by builder, and owned by the library, the
+        // first time the type is looked up; concurrent first lookups wait for it to be built.
+        void add(std::string_view name, builder_t builder);
+        bool exists(std::string_view name) const noexcept;
+        bool exists(Symbol name) const noexcept;
+
+        template <typename R, typename... Ts>
+        R *instantiate(std::string_view name, Ts... args)
+        {
+            return metaObject(name).template instantiate<R>(args...);
+        }
+
+        template <typename R, typename... Ts>
+        R *construct(std::string_view name, std::pmr::memory_resource &resource, Ts... args)
+        {
+            return metaObject(name).template construct<R>(resource, args...);
+        }
 
         template <typename R, typename... Ts>
-        R *instantiate(std::string name, Ts... args)
+        R *construct(std::string_view name, utility::arena &arena, Ts... args)
         {
-            return metaObject(name).instantiate(args);
+            return metaObject(name).template construct<R>(arena, args...);
         }
 
-        std::vector<const MetaObject *> metaObjects() const noexcept;
-        const MetaObject &metaObject(std::string name) const;
+        std::vector<const MetaObject *> metaObjects() const;
+        const MetaObject &metaObject(std::string_view name) const;
+        const MetaObject &metaObject(Symbol name) const;
+
+        // Null if no such type is registered
+        const MetaObject *findMetaObject(std::string_view name) const;
+        const MetaObject *findMetaObject(Symbol name) const;
+
+        // Builds a perfect hash index over all registered types. Types added afterwards are still found
+        // through the regular table until the next call.
+        void finalize();
+        bool finalized() const noexcept;
+
+        // Exports all registered types to a position independent image, see SchemaSnapshot. Types and
+        // their members are ordered by name, so equal schemas produce identical images.
+        std::vector<std::byte> snapshot() const;
+        void snapshot(const std::string &path) const;
+
+        // Metrics of all members of the registered types that were called since the last reset, see
+        // Metrics. Always empty unless built with REFLECTION_METRICS.
+        std::vector<MemberMetrics> metrics() const;
+        void resetMetrics() const;
+
+        // Heap memory held by all materialized types and the lookup tables of the library itself, which
+        // count towards tables
+        MemoryUsage memoryUsage() const;
 
     private:
+        // Registered types except the declared ones not materialized yet
+        std::vector<const MetaObject *> materialized() const;
+
         struct State;
         std::unique_ptr<State> d;
     };
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace lh::reflection
+{
+    // Heap memory held by reflection metadata, in bytes and by what it is spent on. The figures are
+    // derived from the sizes and capacities of the containers involved, so they leave out the
+    // bookkeeping of the allocator itself, and memory shared between types, like interned symbols.
+    struct MemoryUsage
+    {
+        // Names of types and members too long for the small string buffer
+        std::size_t names = 0;
+
+        // Member, constructor and lookup tables, including the members stored in them, and base lists
+        std::size_t tables = 0;
+
+        // Overload tables of methods, including the overloads stored in them
+        std::size_t overloads = 0;
+
+        // Argument type lists of overloads, constructors and events
+        std::size_t argumentTypes = 0;
+
+        // Callables too large to be stored inline, which GenericFunction keeps in a std::function
+        std::size_t captures = 0;
+
+        // Event subscriptions of instances, see Reflectable::memoryUsage. Unlike members, every subscription
+        // allocates a handler record, which deliveries queued on an EventBus share.
+        std::size_t subscriptions = 0;
+
+        // Shards of member metrics that recorded calls, see Metrics
+        std::size_t metrics = 0;
+
+        std::size_t total() const noexcept
+        {
+            return names + tables + overloads + argumentTypes + captures + subscriptions + metrics;
+        }
+
+        MemoryUsage &operator+=(const MemoryUsage &other) noexcept
+        {
+            names += other.names;
+            tables += other.tables;
+            overloads += other.overloads;
+            argumentTypes += other.argumentTypes;
+            captures += other.captures;
+            subscriptions += other.subscriptions;
+            metrics += other.metrics;
+            return *this;
+        }
+    };
+}
+
+namespace lh::reflection::utility
+{
+    // Heap bytes of a string, 0 while it fits into the small string buffer
+    inline std::size_t heapSize(const std::string &string) noexcept
+    {
+        const auto object = reinterpret_cast<const char *>(&string);
+        const auto data = string.data();
+        const bool local = data >= object && data < object + sizeof(std::string);
+        return local ? 0 : string.capacity() + 1;
+    }
+
+    template <typename T>
+    std::size_t heapSize(const std::vector<T> &vector) noexcept
+    {
+        return vector.capacity() * sizeof(T);
+    }
+}
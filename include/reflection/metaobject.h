@@ -1,16 +1,22 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
 #include <algorithm>
+#include <iterator>
 #include <functional>
+#include <memory_resource>
 
 #include "reflection/utility.h"
+#include "reflection/symbol.h"
 #include "reflection/constructor.h"
 #include "reflection/method.h"
 #include "reflection/property.h"
 #include "reflection/event.h"
+#include "reflection/memory_usage.h"
+#include "reflection/sealable_map.h"
+#include "reflection/arena.h"
 
 #ifdef WIN32
 #define CLASS_CALLING_CONVENTION __thiscall
@@ -28,6 +34,24 @@ namespace lh::reflection
             _type(type),
             _bases(bases)
         {
+            for (const auto *base : _bases)
+            {
+                if (std::ranges::find(_ancestors, base) == _ancestors.end())
+                    _ancestors.push_back(base);
+
+                for (const auto *ancestor : base->_ancestors)
+                    if (std::ranges::find(_ancestors, ancestor) == _ancestors.end())
+                        _ancestors.push_back(ancestor);
+            }
+
+            if (!_bases.empty())
+            {
+                _display = _bases.front()->_display;
+                _display.push_back(_bases.front());
+            }
+
+            std::ranges::copy_if(_ancestors, std::back_inserter(_secondary), [this](const MetaObject *ancestor) { return std::ranges::find(_display, ancestor) == _display.end(); });
+            std::ranges::sort(_secondary);
         }
 
         std::string name() const noexcept { return _name; }
@@ -40,32 +64,55 @@ namespace lh::reflection
 
         std::vector<const MetaObject *> bases() const noexcept { return _bases; }
 
-        const MetaObject &base(std::string name) const
+        // Direct and indirect bases, depth first in declaration order
+        std::vector<const MetaObject *> ancestors() const noexcept { return _ancestors; }
+
+        const MetaObject &base(std::string_view name) const
         {
-            if (auto where = std::ranges::find_if(_bases, [&name](const auto &base) { return base->name() == name; }); where != _bases.end())
+            if (auto where = std::ranges::find_if(_ancestors, [&name](const auto &base) { return base->name() == name; }); where != _ancestors.end())
                 return **where;
 
-            throw unknown_type(name);
+            throw unknown_type(std::string(name));
+        }
+
+        bool hasBase(std::string_view name) const noexcept
+        {
+            return std::ranges::any_of(_ancestors, [&name](const auto& base) { return base->name() == name; });
+        }
+
+        // Types are their own subtypes. Ancestors along the chain of first bases sit at their depth in a
+        // display, which makes the check one compare for single inheritance; ancestors reached through
+        // other bases are found by binary search.
+        bool isSubtypeOf(const MetaObject &other) const noexcept
+        {
+            if (&other == this)
+                return true;
+
+            if (const auto depth = other._display.size(); depth < _display.size() && _display[depth] == &other)
+                return true;
+
+            return !_secondary.empty() && std::ranges::binary_search(_secondary, &other);
         }
 
-        bool hasBase(std::string name) const noexcept
+        // Like isSubtypeOf, but only along the chain of first bases, whose members and event ordinals a
+        // type inherits
+        bool isPrimarySubtypeOf(const MetaObject &other) const noexcept
         {
-            return std::ranges::any_of(_bases, [&name](const auto& base) { return base->name() == name; });
+            const auto depth = other._display.size();
+            return &other == this || (depth < _display.size() && _display[depth] == &other);
         }
 
         /* Constructors */
 
         std::vector<const Constructor *> constructors() const noexcept
         {
-            std::vector<const Constructor *> constructors(_constructors.size(), nullptr);
-            std::ranges::transform(_constructors, constructors.begin(), [](const auto &pair) { return &pair.second; });
-            return constructors;
+            return _constructors.values();
         }
 
         const Constructor &constructor(std::size_t hash) const
         {
-            if (auto where = _constructors.find(hash); where != _constructors.end())
-                return where->second;
+            if (auto found = _constructors.find(hash))
+                return *found;
 
             throw unknown_constructor(std::to_string(hash));
         }
@@ -75,134 +122,342 @@ namespace lh::reflection
             return _constructors.contains(hash);
         }
 
-        template <typename R, typename... Ts>
-        void addConstructor(std::function<R(Ts...)> constructor)
+        // Constructor taking Ts as declared, or else the one taking them with other cv- and reference
+        // qualifiers, for arguments passed by value
+        template <typename... Ts>
+        const Constructor &constructor() const
         {
-            const auto hash = utility::signatureHash<Ts...>();
+            if (auto found = _constructors.find(utility::signatureHash<Ts...>()))
+                return *found;
+
+            const Constructor *found = nullptr;
+            if constexpr ((std::is_same_v<Ts, std::remove_cvref_t<Ts>> && ...))
+            {
+                constexpr auto hash = utility::signatureHash<Ts...>();
+                _constructors.forEach([&found](const Constructor &constructor) {
+                    if (!found && constructor.valueSignature() == hash)
+                        found = &constructor;
+                });
+            }
+
+            if (!found)
+                throw unknown_constructor(name() + "(" + utility::signatureString<Ts...>() + ")");
+
+            return *found;
+        }
+
+        template <typename F>
+        void addConstructor(F constructor)
+        {
+            addConstructor(std::move(constructor), utility::signature_of<F>());
+        }
+
+        // Registers the constructor C(Ts...) of the reflected type itself. Unlike factories, these can
+        // construct instances into a memory resource, an arena or a Pool.
+        template <typename C, typename... Ts>
+        void addConstructor()
+        {
+            checkUnsealed("constructor " + name() + "(" + utility::signatureString<Ts...>() + ")");
+
+            if (typeid(C) != _type)
+                throw registration_failed("constructor of " + std::string(typeid(C).name()) + " cannot construct type " + name());
+
+            constexpr auto hash = utility::signatureHash<Ts...>();
             if (_constructors.contains(hash))
                 throw registration_failed("constructor " + name() + "(" + utility::signatureString<Ts...>() + ") is already registered");
 
-            _constructors.emplace(hash, Constructor(constructor));
+            _constructors.emplace(hash, Constructor(std::type_identity<C(Ts...)>()));
+
+            if constexpr (std::is_trivially_destructible_v<C>)
+                _layout = Layout{sizeof(C), alignof(C), nullptr};
+            else
+                _layout = Layout{sizeof(C), alignof(C), [](void *instance) noexcept { std::destroy_at(static_cast<C *>(instance)); }};
         }
 
         /* Methods */
 
         std::vector<const Method *> methods() const noexcept
         {
-            std::vector<const Method *> methods(_methods.size(), nullptr);
-            std::ranges::transform(_methods, methods.begin(), [](const auto &pair) { return &(pair.second); });
-            return methods;
+            return _methods.values();
         }
 
-        const Method &method(std::string name) const
+        const Method &method(std::string_view name) const
         {
-            if (auto where = _methods.find(name); where != _methods.end())
-                return where->second;
+            if (auto found = findMethod(name))
+                return *found;
 
-            throw unknown_method(name);
+            throw unknown_method(std::string(name));
         }
 
-        bool hasMethod(std::string name) const noexcept
+        const Method &method(Symbol name) const
         {
-            return _methods.contains(name);
+            if (auto found = findMethod(name))
+                return *found;
+
+            throw unknown_method(std::string(name.name()));
         }
 
-        template <typename R, typename C, typename... Ts>
-        void addMethod(std::string name, std::function<R(C *, Ts...)> fn, Method::Qualifier qualifier)
+        // Null if there is no such method, which saves the separate hasMethod lookup
+        const Method *findMethod(std::string_view name) const noexcept
+        {
+            if (auto symbol = Symbol::find(name))
+                return findMethod(symbol);
+
+            return nullptr;
+        }
+
+        const Method *findMethod(Symbol name) const noexcept
+        {
+            return resolve(_methods, _resolvedMethods, name);
+        }
+
+        bool hasMethod(std::string_view name) const noexcept
         {
-            if (!_methods.contains(name))
-                _methods.emplace(name, Method(name));
+            return hasMethod(Symbol::find(name));
+        }
 
-            _methods.at(name).addOverload(fn, qualifier);
+        bool hasMethod(Symbol name) const noexcept
+        {
+            return resolve(_methods, _resolvedMethods, name) != nullptr;
         }
 
         template <typename R, typename... Ts>
-        void addMethod(std::string name, std::function<R(Ts...)> fn)
+        MethodHandle<R, Ts...> methodHandle(std::string_view name, Method::Qualifier qualifier = Method::Qualifier::Static) const
         {
-            if (!_methods.contains(name))
-                _methods.emplace(name, Method(name));
+            return method(name).handle<R, Ts...>(qualifier);
+        }
 
-            _methods.at(name).addOverload(fn);
+        template <utility::function_object F>
+        void addMethod(std::string name, F fn, Method::Qualifier qualifier)
+        {
+            addOverload(name, std::move(fn), utility::signature_of<F>(), qualifier);
+        }
+
+        template <utility::function_object F>
+        void addMethod(std::string name, F fn)
+        {
+            addOverload(name, std::move(fn), utility::signature_of<F>());
         }
 
         template <typename R, typename C, typename... Ts>
         void addMethod(std::string name, R (CLASS_CALLING_CONVENTION C::*fn_ptr)(Ts...))
         {
-            addMethod(name, std::function<R(C *, Ts...)>(fn_ptr), Method::Qualifier::Mutable);
+            addOverload(name, fn_ptr, std::type_identity<R(C *, Ts...)>(), Method::Qualifier::Mutable);
         }
 
         template <typename R, typename C, typename... Ts>
         void addMethod(std::string name, R (CLASS_CALLING_CONVENTION C::*fn_ptr)(Ts...) const)
         {
-            addMethod(name, std::function<R(C *, Ts...)>(fn_ptr), Method::Qualifier::Immutable);
+            addOverload(name, fn_ptr, std::type_identity<R(C *, Ts...)>(), Method::Qualifier::Immutable);
         }
 
         template <typename R, typename... Ts>
         void addMethod(std::string name, R fn_ptr(Ts...))
         {
-            addMethod(name, std::function<R(Ts...)>(fn_ptr), Method::Qualifier::Static);
+            addOverload(name, fn_ptr, std::type_identity<R(Ts...)>());
         }
 
         /* Properties */
 
         std::vector<const Property *> properties() const noexcept
         {
-            std::vector<const Property *> properties(_properties.size(), nullptr);
-            std::ranges::transform(_properties, properties.begin(), [](const auto &pair) { return &pair.second; });
-            return properties;
+            return _properties.values();
         }
 
-        const Property &property(std::string name) const
+        const Property &property(std::string_view name) const
         {
-            if (auto where = _properties.find(name); where != _properties.end())
-                return where->second;
+            if (auto found = findProperty(name))
+                return *found;
 
-            throw unknown_property(name);
+            throw unknown_property(std::string(name));
         }
 
-        bool hasProperty(std::string name) const noexcept
+        const Property &property(Symbol name) const
         {
-            return _properties.contains(name);
+            if (auto found = findProperty(name))
+                return *found;
+
+            throw unknown_property(std::string(name.name()));
         }
 
+        const Property *findProperty(std::string_view name) const noexcept
+        {
+            if (auto symbol = Symbol::find(name))
+                return findProperty(symbol);
+
+            return nullptr;
+        }
+
+        const Property *findProperty(Symbol name) const noexcept
+        {
+            return resolve(_properties, _resolvedProperties, name);
+        }
+
+        bool hasProperty(std::string_view name) const noexcept
+        {
+            return hasProperty(Symbol::find(name));
+        }
+
+        bool hasProperty(Symbol name) const noexcept
+        {
+            return resolve(_properties, _resolvedProperties, name) != nullptr;
+        }
+
+        template <typename T>
+        PropertyHandle<T> propertyHandle(std::string_view name) const
+        {
+            return property(name).handle<T>();
+        }
+
+        template <typename G, typename S>
+        void addProperty(std::string name, G getter, S setter)
+        {
+            checkUnsealed("property " + name);
+
+            auto symbol = Symbol::intern(name);
+            if (_properties.contains(symbol))
+                throw registration_failed("property " + name + " is already registered");
+
+            _properties.emplace(symbol, Property(name, std::move(getter), std::move(setter), utility::signature_of<G>()));
+        }
+
+        // Property backed by a data member, which get and set access in place instead of calling accessors
         template <typename C, typename T>
-        void addProperty(std::string name, std::function<T(const C *)> getter, std::function<void(C *, T)> setter)
+            requires std::is_member_object_pointer_v<T C::*>
+        void addProperty(std::string name, T C::*member)
         {
-            if (_properties.contains(name))
+            static_assert(!std::is_const_v<T>, "property cannot be backed by a const data member");
+
+            checkUnsealed("property " + name);
+
+            auto symbol = Symbol::intern(name);
+            if (_properties.contains(symbol))
                 throw registration_failed("property " + name + " is already registered");
 
-            _properties.emplace(name, Property(name, getter, setter));
+            _properties.emplace(symbol, Property(name, member));
         }
 
         /* Events */
 
         std::vector<const Event *> events() const noexcept
         {
-            std::vector<const Event *> events(_events.size(), nullptr);
-            std::ranges::transform(_events, events.begin(), [](const auto &pair) { return &pair.second; });
-            return events;
+            return _events.values();
+        }
+
+        const Event &event(std::string_view name) const
+        {
+            if (auto found = findEvent(name))
+                return *found;
+
+            throw unknown_event(std::string(name));
+        }
+
+        const Event &event(Symbol name) const
+        {
+            if (auto found = findEvent(name))
+                return *found;
+
+            throw unknown_event(std::string(name.name()));
+        }
+
+        const Event *findEvent(std::string_view name) const noexcept
+        {
+            if (auto symbol = Symbol::find(name))
+                return findEvent(symbol);
+
+            return nullptr;
+        }
+
+        const Event *findEvent(Symbol name) const noexcept
+        {
+            return resolve(_events, _resolvedEvents, name);
         }
 
-        const Event &event(std::string name) const
+        bool hasEvent(std::string_view name) const noexcept
         {
-            if (auto where = _events.find(name); where != _events.end())
-                return where->second;
+            return hasEvent(Symbol::find(name));
+        }
 
-            throw unknown_event(name);
+        bool hasEvent(Symbol name) const noexcept
+        {
+            return resolve(_events, _resolvedEvents, name) != nullptr;
         }
 
-        bool hasEvent(std::string name) const noexcept
+        template <typename... Ts>
+        EventHandle<Ts...> eventHandle(std::string_view name) const
         {
-            return _events.contains(name);
+            auto handle = event(name).template handle<Ts...>();
+            handle._owner = this;
+            return handle;
         }
 
         template <typename... Ts>
         void addEvent(std::string name)
         {
-            if (_events.contains(name))
+            checkUnsealed("event " + name);
+
+            auto symbol = Symbol::intern(name);
+            if (_events.contains(symbol))
                 throw registration_failed("event " + name + " is already registered");
 
-            _events.emplace(name, Event(name, utility::signature<Ts...>()));
+            // Ordinals are final when the event is added, numbered after the events of the first base, so
+            // that subscriptions made before sealing keep referring to the same event
+            if (_events.size() == 0)
+                _inheritedEvents = _bases.empty() ? 0 : _bases.front()->_eventCount;
+
+            _events.emplace(symbol, Event(name, std::type_identity<void(Ts...)>(), _inheritedEvents + _events.size()));
+            _eventCount = _inheritedEvents + _events.size();
+        }
+
+        /* Sealing */
+
+        bool sealed() const noexcept { return _sealed; }
+
+        // Compacts all members into contiguous tables and rejects further registrations. Members are
+        // moved, so references and handles obtained before sealing are invalidated. Sealing also flattens
+        // the members inherited from the first base into the lookup tables, which requires the first base
+        // to be sealed before. Other bases only take part in subtype checks, since their instances do not
+        // share the address of the derived instance that members are called with.
+        void seal()
+        {
+            if (_sealed)
+                return;
+
+            const MetaObject *primary = _bases.empty() ? nullptr : _bases.front();
+            if (primary && !primary->sealed())
+                throw registration_failed("base " + primary->name() + " has to be sealed before " + name());
+
+            // Own events were numbered after the events the first base had when they were added
+            const auto inheritedEvents = primary ? primary->_eventCount : 0;
+            if (_events.size() != 0 && inheritedEvents != _inheritedEvents)
+                throw registration_failed("events were added to base " + primary->name() + " after events of " + name());
+
+            _inheritedEvents = inheritedEvents;
+            _eventCount = inheritedEvents + _events.size();
+
+            _methods.forEach([](Method &method) { method.seal(); });
+
+            _constructors.seal();
+            _methods.seal();
+            _properties.seal();
+            _events.seal();
+
+            if (primary)
+            {
+                auto methods = primary->flatMembers(primary->_methods, primary->_resolvedMethods);
+                auto properties = primary->flatMembers(primary->_properties, primary->_resolvedProperties);
+                auto events = primary->flatMembers(primary->_events, primary->_resolvedEvents);
+
+                if (!methods.empty() || !properties.empty() || !events.empty())
+                {
+                    flatten(_resolvedMethods, _methods, methods);
+                    flatten(_resolvedProperties, _properties, properties);
+                    flatten(_resolvedEvents, _events, events);
+                    _flattened = true;
+                }
+            }
+
+            _sealed = true;
         }
 
         /* Factory */
@@ -210,24 +465,213 @@ namespace lh::reflection
         template <typename R, typename... Ts>
         R *instantiate(Ts... args) const try
         {
-            static const auto hash = utility::signatureHash<Ts...>();
-            return constructor(hash)->invoke(args);
+            return constructor<Ts...>().template invoke<R *>(args...);
         }
         catch (const unknown_constructor &)
         {
             throw unknown_constructor(name() + "(" + utility::signatureString<Ts...>() + ")");
         }
 
+        // Constructs into memory from resource, to be destroyed with destroy()
+        template <typename R, typename... Ts>
+        R *construct(std::pmr::memory_resource &resource, Ts... args) const
+        {
+            const auto &layout = placeableLayout();
+            auto where = resource.allocate(layout.size, layout.alignment);
+
+            try
+            {
+                return constructAt<R>(where, args...);
+            }
+            catch (...)
+            {
+                resource.deallocate(where, layout.size, layout.alignment);
+                throw;
+            }
+        }
+
+        // Constructs into the arena, the instance is destroyed when the arena is released
+        template <typename R, typename... Ts>
+        R *construct(utility::arena &arena, Ts... args) const
+        {
+            const auto &layout = placeableLayout();
+            auto instance = constructAt<R>(arena.allocate(layout.size, layout.alignment), args...);
+
+            if (layout.destroy)
+            {
+                try
+                {
+                    arena.adopt(static_cast<void *>(instance), layout.destroy);
+                }
+                catch (...)
+                {
+                    layout.destroy(instance);
+                    throw;
+                }
+            }
+
+            return instance;
+        }
+
+        // Constructs into where, which has to fit instanceSize() bytes at instanceAlignment()
+        template <typename R, typename... Ts>
+        R *constructAt(void *where, Ts... args) const try
+        {
+            return constructor<Ts...>().template place<R *>(where, args...);
+        }
+        catch (const unknown_constructor &)
+        {
+            throw unknown_constructor(name() + "(" + utility::signatureString<Ts...>() + ")");
+        }
+
+        // Runs the destructor of an instance constructed in place
+        void destruct(void *instance) const noexcept
+        {
+            if (_layout.destroy)
+                _layout.destroy(instance);
+        }
+
+        void destroy(void *instance, std::pmr::memory_resource &resource) const
+        {
+            destruct(instance);
+            resource.deallocate(instance, _layout.size, _layout.alignment);
+        }
+
+        // Known once a constructor of the reflected type itself is registered, 0 before
+        std::size_t instanceSize() const noexcept { return _layout.size; }
+        std::size_t instanceAlignment() const noexcept { return _layout.alignment; }
+
+        // Heap memory held by the type beyond its own size. Inherited members are counted with the base
+        // declaring them, only the entries of the flattened tables pointing at them are counted here.
+        MemoryUsage memoryUsage() const noexcept
+        {
+            MemoryUsage usage;
+            usage.names = utility::heapSize(_name);
+            usage.tables = utility::heapSize(_bases) + utility::heapSize(_ancestors) + utility::heapSize(_display) + utility::heapSize(_secondary);
+            usage.tables += _constructors.heapSize() + _methods.heapSize() + _properties.heapSize() + _events.heapSize();
+            usage.tables += _resolvedMethods.heapSize() + _resolvedProperties.heapSize() + _resolvedEvents.heapSize();
+
+            const auto add = [&usage](const auto &member) { usage += member.memoryUsage(); };
+            _constructors.forEach(add);
+            _methods.forEach(add);
+            _properties.forEach(add);
+            _events.forEach(add);
+
+            return usage;
+        }
+
     private:
+        struct Layout
+        {
+            std::size_t size = 0;
+            std::size_t alignment = 0;
+            utility::arena::destroy_t destroy = nullptr;
+        };
+
+        // Once flattened, all lookups take one probe into the flat table, inherited or not
+        template <typename V>
+        const V *resolve(const utility::sealable_map<Symbol, V> &own, const utility::sealable_map<Symbol, const V *> &flat, Symbol name) const noexcept
+        {
+            if (_flattened)
+            {
+                auto found = flat.find(name);
+                return found ? *found : nullptr;
+            }
+
+            return own.find(name);
+        }
+
+        template <typename V>
+        std::vector<const V *> flatMembers(const utility::sealable_map<Symbol, V> &own, const utility::sealable_map<Symbol, const V *> &flat) const
+        {
+            if (!_flattened)
+                return own.values();
+
+            std::vector<const V *> members;
+            std::ranges::transform(flat.values(), std::back_inserter(members), [](const V *const *member) { return *member; });
+            return members;
+        }
+
+        // Own members hide inherited ones of the same name
+        template <typename V>
+        static void flatten(utility::sealable_map<Symbol, const V *> &flat, const utility::sealable_map<Symbol, V> &own, const std::vector<const V *> &inherited)
+        {
+            for (const auto *member : own.values())
+                flat.emplace(Symbol::intern(member->name()), member);
+
+            for (const auto *member : inherited)
+                if (auto symbol = Symbol::intern(member->name()); !flat.contains(symbol))
+                    flat.emplace(symbol, member);
+
+            flat.seal();
+        }
+
+        const Layout &placeableLayout() const
+        {
+            if (!_layout.size)
+                throw instantiation_failed("type " + name() + " has no constructor that can construct in place");
+
+            return _layout;
+        }
+
+        template <typename R, typename... Ts, typename F>
+        void addConstructor(F constructor, std::type_identity<R(Ts...)> signature)
+        {
+            checkUnsealed("constructor " + name() + "(" + utility::signatureString<Ts...>() + ")");
+
+            constexpr auto hash = utility::signatureHash<Ts...>();
+            if (_constructors.contains(hash))
+                throw registration_failed("constructor " + name() + "(" + utility::signatureString<Ts...>() + ") is already registered");
+
+            _constructors.emplace(hash, Constructor(std::move(constructor), signature));
+        }
+
+        // A new method is only added with its first overload, so that a callable failing to be stored
+        // leaves no empty method behind
+        template <typename... Args>
+        void addOverload(std::string name, Args &&...args)
+        {
+            checkUnsealed("method " + name);
+
+            auto symbol = Symbol::intern(name);
+            if (auto found = _methods.find(symbol))
+                return found->addOverload(std::forward<Args>(args)...);
+
+            Method method(name);
+            method.addOverload(std::forward<Args>(args)...);
+            _methods.emplace(symbol, std::move(method));
+        }
+
+        void checkUnsealed(const std::string &member) const
+        {
+            if (_sealed)
+                throw registration_failed(member + " cannot be added to sealed type " + name());
+        }
+
         std::string _name;
         std::type_index _type;
 
         std::vector<const MetaObject *> _bases;
-
-        std::unordered_map<std::size_t, Constructor> _constructors;
-        std::unordered_map<std::string, Method> _methods;
-        std::unordered_map<std::string, Property> _properties;
-        std::unordered_map<std::string, Event> _events;
+        std::vector<const MetaObject *> _ancestors;
+
+        // First bases from the root down, and all other ancestors sorted by address
+        std::vector<const MetaObject *> _display;
+        std::vector<const MetaObject *> _secondary;
+
+        bool _sealed = false;
+        Layout _layout;
+
+        utility::sealable_map<std::size_t, Constructor> _constructors;
+        utility::sealable_map<Symbol, Method> _methods;
+        utility::sealable_map<Symbol, Property> _properties;
+        utility::sealable_map<Symbol, Event> _events;
+
+        bool _flattened = false;
+        std::size_t _inheritedEvents = 0;
+        std::size_t _eventCount = 0;
+        utility::sealable_map<Symbol, const Method *> _resolvedMethods;
+        utility::sealable_map<Symbol, const Property *> _resolvedProperties;
+        utility::sealable_map<Symbol, const Event *> _resolvedEvents;
     };
 }
 
@@ -1,19 +1,28 @@
 #pragma once
 
+#include <span>
+#include <optional>
 #include <string>
 #include <vector>
-#include <unordered_map>
 #include <algorithm>
-#include <memory>
 #include <functional>
 #include <typeindex>
 
 #include "reflection/utility.h"
 #include "reflection/function.h"
+#include "reflection/value.h"
+#include "reflection/metrics.h"
+#include "reflection/memory_usage.h"
+#include "reflection/result.h"
+#include "reflection/thread_pool.h"
 #include "reflection/exceptions.h"
+#include "reflection/sealable_map.h"
 
 namespace lh::reflection
 {
+    template <typename R, typename... Ts>
+    class MethodHandle;
+
     class Method final : private utility::non_copyable
     {
     public:
@@ -26,54 +35,165 @@ namespace lh::reflection
 
         class Overload final : private utility::non_copyable
         {
+            friend class Method;
+
+            template <typename R, typename... Ts>
+            friend class MethodHandle;
+
         public:
-            template <typename R, typename C, typename... Ts>
-            explicit Overload(std::function<R(C *, Ts...)> fn, Qualifier qualifier) noexcept :
+            // Instances are passed to the stored function as void *, so member and static overloads share
+            // one calling convention and MethodHandle can call the stored trampoline directly.
+            template <typename R, typename C, typename... Ts, typename F>
+            explicit Overload(F fn, std::type_identity<R(C *, Ts...)>, Qualifier qualifier) :
                 _returnType(typeid(R)),
+                _returnTypeId(utility::typeId<R>()),
                 _argumentTypes(utility::signature<Ts...>()),
-                _function(std::make_unique<SpecificFunction<R, C *, Ts...>>(fn)),
+                _signature(utility::signatureHash<Ts...>()),
+                _valueSignature(utility::signatureHash<std::remove_cvref_t<Ts>...>()),
+                _function(SpecificFunction<R, void *, Ts...>([fn](void *instance, Ts... args) mutable -> R {
+                    return std::invoke(fn, static_cast<C *>(instance), std::forward<Ts>(args)...);
+                })),
+                _dynamic(&invokeValues<R, Ts...>),
+                _byValue(reinterpret_cast<void (*)()>(&callByValue<R, Ts...>)),
                 _qualifier(qualifier)
             {
             }
 
-            template <typename R, typename... Ts>
-            explicit Overload(std::function<R(Ts...)> fn) noexcept :
+            template <typename R, typename... Ts, typename F>
+            explicit Overload(F fn, std::type_identity<R(Ts...)>) :
                 _returnType(typeid(R)),
+                _returnTypeId(utility::typeId<R>()),
                 _argumentTypes(utility::signature<Ts...>()),
-                _function(std::make_unique<SpecificFunction<R, Ts...>>(fn)),
+                _signature(utility::signatureHash<Ts...>()),
+                _valueSignature(utility::signatureHash<std::remove_cvref_t<Ts>...>()),
+                _function(SpecificFunction<R, void *, Ts...>([fn](void *, Ts... args) mutable -> R {
+                    return std::invoke(fn, std::forward<Ts>(args)...);
+                })),
+                _dynamic(&invokeValues<R, Ts...>),
+                _byValue(reinterpret_cast<void (*)()>(&callByValue<R, Ts...>)),
                 _qualifier(Method::Qualifier::Static)
             {
             }
 
             std::type_index returnType() const noexcept { return _returnType; }
             std::vector<std::type_index> argumentTypes() const noexcept { return _argumentTypes; }
-            std::size_t hash() const noexcept { return _function->hash(); };
+            std::size_t hash() const noexcept { return _function.hash(); };
+
+            // Hash of the arguments without the instance, which is what overloads are looked up by
+            std::size_t signature() const noexcept { return _signature; }
+
+            // Hash of the argument types with cv- and reference qualifiers removed, which is what the
+            // arguments of a dynamic call are matched against
+            std::size_t valueSignature() const noexcept { return _valueSignature; }
 
             Qualifier qualifier() const noexcept { return _qualifier; };
 
+#ifdef REFLECTION_METRICS
+            const Metrics &metrics() const noexcept { return _metrics; }
+#endif
+
             template <typename R, typename C, typename... Ts>
             R invoke(C *instance, Ts... args) const
             {
-                if (typeid(R).hash_code() != returnType().hash_code())
+                if (utility::typeId<R>() != _returnTypeId)
                     throw invalid_method_type("type " + std::string(typeid(R).name()) + " is incompatible with return type " + std::string(returnType().name()));
 
-                return _function->invoke<R>(instance, args...);
+#ifdef REFLECTION_METRICS
+                const Metrics::Scope scope(_metrics);
+#endif
+                return _function.invoke<R>(const_cast<void *>(static_cast<const void *>(instance)), std::forward<Ts>(args)...);
             }
 
             template <typename R, typename... Ts>
             R invoke(Ts... args) const
             {
-                if (typeid(R).hash_code() != returnType().hash_code())
+                if (utility::typeId<R>() != _returnTypeId)
                     throw invalid_method_type("type " + std::string(typeid(R).name()) + " is incompatible with return type " + std::string(returnType().name()));
 
-                return _function->invoke<R>(args...);
+#ifdef REFLECTION_METRICS
+                const Metrics::Scope scope(_metrics);
+#endif
+                return _function.invoke<R>(static_cast<void *>(nullptr), std::forward<Ts>(args)...);
+            }
+
+            // Arguments taken by value or rvalue reference are moved out of their values. The result is
+            // returned by value, and empty for void.
+            template <typename C>
+            Value invokeDynamic(C *instance, std::span<Value> arguments) const
+            {
+                checkValues(arguments);
+#ifdef REFLECTION_METRICS
+                const Metrics::Scope scope(_metrics);
+#endif
+                return _dynamic(_function, const_cast<void *>(static_cast<const void *>(instance)), arguments);
+            }
+
+            Value invokeDynamic(std::span<Value> arguments) const
+            {
+                checkValues(arguments);
+#ifdef REFLECTION_METRICS
+                const Metrics::Scope scope(_metrics);
+#endif
+                return _dynamic(_function, nullptr, arguments);
             }
 
         private:
+            using dynamic_t = Value (*)(const GenericFunction &function, void *instance, std::span<Value> arguments);
+
+            // Calls with arguments held by value, which the overload may take by reference or cv-qualified,
+            // see Method::invoke. Ts have to be the argument types without cv- and reference qualifiers.
+            template <typename R, typename... Ts>
+            R invokeByValue(void *instance, Ts &...args) const
+            {
+                if (utility::typeId<R>() != _returnTypeId)
+                    throw invalid_method_type("type " + std::string(typeid(R).name()) + " is incompatible with return type " + std::string(returnType().name()));
+
+#ifdef REFLECTION_METRICS
+                const Metrics::Scope scope(_metrics);
+#endif
+                return reinterpret_cast<R (*)(const GenericFunction &, void *, Ts &...)>(_byValue)(_function, instance, args...);
+            }
+
+            template <typename R, typename... Ts>
+            static R callByValue(const GenericFunction &function, void *instance, std::remove_cvref_t<Ts> &...args)
+            {
+                return function.invoke<R, void *, Ts...>(instance, std::forward<Ts>(args)...);
+            }
+
+            template <typename R, typename... Ts>
+            static Value invokeValues(const GenericFunction &function, void *instance, std::span<Value> arguments)
+            {
+                return [&]<std::size_t... Is>(std::index_sequence<Is...>) -> Value {
+                    if constexpr (std::is_void_v<R>)
+                    {
+                        function.invoke<void, void *, Ts...>(instance, arguments[Is].template pass<Ts>()...);
+                        return Value();
+                    }
+                    else
+                    {
+                        return Value(function.invoke<R, void *, Ts...>(instance, arguments[Is].template pass<Ts>()...));
+                    }
+                }(std::index_sequence_for<Ts...>());
+            }
+
+            void checkValues(std::span<const Value> arguments) const
+            {
+                if (arguments.size() != _argumentTypes.size() || Value::signatureHash(arguments) != _valueSignature)
+                    throw invalid_method_type("values " + Value::signatureString(arguments) + " are incompatible with arguments " + utility::signatureString(_argumentTypes));
+            }
+
             std::type_index _returnType;
+            std::size_t _returnTypeId;
             std::vector<std::type_index> _argumentTypes;
-            std::unique_ptr<GenericFunction> _function;
+            std::size_t _signature;
+            std::size_t _valueSignature;
+            GenericFunction _function;
+            dynamic_t _dynamic;
+            void (*_byValue)(); // callByValue for the argument types of the overload
             Qualifier _qualifier;
+#ifdef REFLECTION_METRICS
+            Metrics _metrics;
+#endif
         };
 
         explicit Method(std::string name) noexcept :
@@ -85,54 +205,119 @@ namespace lh::reflection
 
         std::vector<const Overload *> overloads() const noexcept
         {
-            std::vector<const Overload *> overloads(_overloads.size(), nullptr);
-            std::ranges::transform(_overloads, overloads.begin(), [](const auto &pair) { return &pair.second; });
-            return overloads;
+            return _overloads.values();
+        }
+
+        // Heap memory held by the method and its overloads beyond its own size
+        MemoryUsage memoryUsage() const noexcept
+        {
+            MemoryUsage usage;
+            usage.names = utility::heapSize(_name);
+            usage.overloads = _overloads.heapSize() + _records.heapSize();
+
+            _overloads.forEach([&usage](const Overload &overload) {
+                usage.argumentTypes += utility::heapSize(overload._argumentTypes);
+                usage.captures += overload._function.allocated();
+#ifdef REFLECTION_METRICS
+                usage.metrics += overload._metrics.allocated();
+#endif
+            });
+
+            return usage;
         }
 
         const Overload &overload(std::size_t hash, Qualifier qualifier) const
         {
-            if (auto where = _overloads.find({hash, qualifier}); where != _overloads.end())
-                return where->second;
-            else if(qualifier == Qualifier::Mutable) // const methods can be called on non-const objects
-                if (auto where = _overloads.find({hash, Qualifier::Immutable}); where != _overloads.end())
-                    return where->second;
+            if (auto found = findOverload(hash, qualifier))
+                return *found;
 
             throw unknown_method("unknown signature " + std::to_string(hash) + " for method " + name());
         }
 
+        const Overload *findOverload(std::size_t hash, Qualifier qualifier) const noexcept
+        {
+            if (auto found = _overloads.find({hash, qualifier}))
+                return found;
+            else if (qualifier == Qualifier::Mutable) // const methods can be called on non-const objects
+                return _overloads.find({hash, Qualifier::Immutable});
+
+            return nullptr;
+        }
+
         bool hasOverload(std::size_t hash, Qualifier qualifier) const noexcept
         {
             return _overloads.contains({hash, qualifier});
         }
 
-        template <typename R, typename C, typename... Ts>
-        void addOverload(std::function<R(C *, Ts...)> fn, Method::Qualifier qualifier)
+        template <typename R, typename C, typename... Ts, typename F>
+        void addOverload(F fn, std::type_identity<R(C *, Ts...)> signature, Method::Qualifier qualifier)
         {
-            const auto hash = utility::signatureHash<Ts...>();
+            constexpr auto hash = utility::signatureHash<Ts...>();
+
+            if (sealed())
+                throw registration_failed("method " + name() + " is sealed");
 
             if (_overloads.contains({hash, qualifier}))
                 throw registration_failed("method overload with signature " + name() + "(" + utility::signatureString<Ts...>() + ") is already registered");
 
-            _overloads.emplace(overload_index{hash, qualifier}, Overload(fn, qualifier));
+            _overloads.emplace(overload_index{hash, qualifier}, Overload(std::move(fn), signature, qualifier));
         }
 
-        template <typename R, typename... Ts>
-        void addOverload(std::function<R(Ts...)> fn)
+        template <typename R, typename... Ts, typename F>
+        void addOverload(F fn, std::type_identity<R(Ts...)> signature)
         {
-            const auto hash = utility::signatureHash<Ts...>();
+            constexpr auto hash = utility::signatureHash<Ts...>();
+
+            if (sealed())
+                throw registration_failed("method " + name() + " is sealed");
 
             if (_overloads.contains({hash, Method::Qualifier::Static}))
                 throw registration_failed("method overload with signature " + name() + "(" + utility::signatureString<Ts...>() + ") is already registered");
 
-            _overloads.emplace(overload_index{hash, Method::Qualifier::Static}, Overload(fn));
+            _overloads.emplace(overload_index{hash, Method::Qualifier::Static}, Overload(std::move(fn), signature));
+        }
+
+        bool sealed() const noexcept { return _overloads.sealed(); }
+
+        // Moves all overloads into one contiguous array indexed by hash, see utility::sealable_map, and
+        // rejects further overloads. Typed calls then go through a table of compact records, see Record.
+        void seal()
+        {
+            if (sealed())
+                return;
+
+            _overloads.seal();
+            _overloads.forEach([this](const Overload &overload) {
+                const auto record = Record{overload._returnTypeId, reinterpret_cast<void (*)()>(overload._function.template trampoline<void>()), overload._function.storage(), &overload};
+                _records.emplace({overload._signature, overload._qualifier}, record);
+            });
+
+            // const methods can be called on non-const objects, without a second lookup once sealed
+            _overloads.forEach([this](const Overload &overload) {
+                if (overload._qualifier == Qualifier::Immutable && !_overloads.contains({overload._signature, Qualifier::Mutable}))
+                    _records.emplace({overload._signature, Qualifier::Mutable}, *_records.find({overload._signature, Qualifier::Immutable}));
+            });
+
+            _records.seal();
         }
 
+        // Overloads taking arguments by reference or cv-qualified are found by the types of the arguments
+        // passed by value as well, see valueOverload
         template <typename R, typename C, typename... Ts>
         R invoke(C *instance, Ts... args, Qualifier qualifier) const try
         {
-            static const auto hash = utility::signatureHash<Ts...>();
-            return overload(hash, qualifier).invoke<R>(instance, args...);
+            constexpr auto hash = utility::signatureHash<Ts...>();
+            if (sealed()) [[likely]]
+            {
+                if (auto record = _records.find({hash, qualifier})) [[likely]]
+                    return record->template invoke<R>(const_cast<void *>(static_cast<const void *>(instance)), args...);
+            }
+            else if (auto found = findOverload(hash, qualifier))
+            {
+                return found->template invoke<R>(instance, args...);
+            }
+
+            return valueOverload<Ts...>(qualifier).template invokeByValue<R>(const_cast<void *>(static_cast<const void *>(instance)), args...);
         }
         catch (const unknown_method &)
         {
@@ -146,8 +331,18 @@ namespace lh::reflection
         template <typename R, typename... Ts>
         R invoke(Ts... args) const try
         {
-            static const auto hash = utility::signatureHash<Ts...>();
-            return overload(hash, Method::Qualifier::Static).invoke<R>(args...);
+            constexpr auto hash = utility::signatureHash<Ts...>();
+            if (sealed()) [[likely]]
+            {
+                if (auto record = _records.find({hash, Method::Qualifier::Static})) [[likely]]
+                    return record->template invoke<R>(nullptr, args...);
+            }
+            else if (auto found = findOverload(hash, Method::Qualifier::Static))
+            {
+                return found->template invoke<R>(args...);
+            }
+
+            return valueOverload<Ts...>(Method::Qualifier::Static).template invokeByValue<R>(nullptr, args...);
         }
         catch (const unknown_method&)
         {
@@ -158,7 +353,201 @@ namespace lh::reflection
             throw invalid_method_type(std::string(e.what()) + " for method " + name());
         }
 
+        // Like invoke, but returns a failure instead of throwing when no overload matches
+        template <typename R, typename C, typename... Ts>
+        Result<R> tryInvoke(C *instance, Ts... args, Qualifier qualifier) const
+        {
+            constexpr auto hash = utility::signatureHash<Ts...>();
+            const auto found = findOverload(hash, qualifier);
+            const auto byValue = found ? nullptr : findValueOverload<Ts...>(qualifier);
+
+            if (auto failure = check<R, Ts...>(found ? found : byValue))
+                return *failure;
+
+            const auto where = const_cast<void *>(static_cast<const void *>(instance));
+            if constexpr (std::is_void_v<R>)
+            {
+                found ? found->template invoke<R>(instance, args...) : byValue->template invokeByValue<R>(where, args...);
+                return {};
+            }
+            else
+            {
+                return found ? found->template invoke<R>(instance, args...) : byValue->template invokeByValue<R>(where, args...);
+            }
+        }
+
+        template <typename R, typename... Ts>
+        Result<R> tryInvoke(Ts... args) const
+        {
+            constexpr auto hash = utility::signatureHash<Ts...>();
+            const auto found = findOverload(hash, Method::Qualifier::Static);
+            const auto byValue = found ? nullptr : findValueOverload<Ts...>(Method::Qualifier::Static);
+
+            if (auto failure = check<R, Ts...>(found ? found : byValue))
+                return *failure;
+
+            if constexpr (std::is_void_v<R>)
+            {
+                found ? found->template invoke<R>(args...) : byValue->template invokeByValue<R>(nullptr, args...);
+                return {};
+            }
+            else
+            {
+                return found ? found->template invoke<R>(args...) : byValue->template invokeByValue<R>(nullptr, args...);
+            }
+        }
+
+        // Picks the overload from the runtime types of the values. Overloads taking their arguments by
+        // value are found by the same hash lookup as typed calls, the others by a scan of the overloads.
+        template <typename C>
+        Value invokeDynamic(C *instance, std::span<Value> arguments, Qualifier qualifier) const
+        {
+            return dynamicOverload(arguments, qualifier).invokeDynamic(instance, arguments);
+        }
+
+        Value invokeDynamic(std::span<Value> arguments) const
+        {
+            return dynamicOverload(arguments, Qualifier::Static).invokeDynamic(arguments);
+        }
+
+        // Calls the method on every instance, resolving it once. Instances of const types get the const
+        // overloads. Arguments are copied for every call.
+        template <typename R = void, typename C, typename... Ts>
+        void invokeAll(std::span<C *> instances, Ts... args) const
+        {
+            handle<R, Ts...>(qualifierFor<C>()).invokeAll(instances, args...);
+        }
+
+        // Stores the result of the call on instances[i] in results[i]
+        template <typename R, typename C, typename... Ts>
+        void invokeAll(std::span<C *> instances, std::span<R> results, Ts... args) const
+        {
+            handle<R, Ts...>(qualifierFor<C>()).invokeAll(instances, results, args...);
+        }
+
+        // Splits the instances into chunks of grain that the pool's threads call in parallel
+        template <typename R = void, typename C, typename... Ts>
+        void invokeAll(ThreadPool &pool, std::size_t grain, std::span<C *> instances, Ts... args) const
+        {
+            handle<R, Ts...>(qualifierFor<C>()).invokeAll(pool, grain, instances, args...);
+        }
+
+        template <typename R, typename C, typename... Ts>
+        void invokeAll(ThreadPool &pool, std::size_t grain, std::span<C *> instances, std::span<R> results, Ts... args) const
+        {
+            handle<R, Ts...>(qualifierFor<C>()).invokeAll(pool, grain, instances, results, args...);
+        }
+
+        template <typename R, typename... Ts>
+        MethodHandle<R, Ts...> handle(Qualifier qualifier) const try
+        {
+            constexpr auto hash = utility::signatureHash<Ts...>();
+            const auto &resolved = overload(hash, qualifier);
+
+            if (utility::typeId<R>() != resolved._returnTypeId)
+                throw invalid_method_type("type " + std::string(typeid(R).name()) + " is incompatible with return type " + std::string(resolved.returnType().name()) + " for method " + name());
+
+            return MethodHandle<R, Ts...>(resolved, qualifier);
+        }
+        catch (const unknown_method &)
+        {
+            throw unknown_method("unknown signature " + name() + "(" + utility::signatureString<Ts...>() + ") for method " + name());
+        }
+
     private:
+        // What a typed call reads of a sealed overload, 32 bytes rather than the whole overload
+        struct Record
+        {
+            std::size_t returnTypeId;
+            void (*trampoline)();
+            const void *storage;
+            const Overload *overload; // for diagnostics and metrics
+
+            template <typename R, typename... Ts>
+            R invoke(void *instance, Ts... args) const
+            {
+                if (utility::typeId<R>() != returnTypeId)
+                    throw invalid_method_type("type " + std::string(typeid(R).name()) + " is incompatible with return type " + std::string(overload->returnType().name()));
+
+#ifdef REFLECTION_METRICS
+                const Metrics::Scope scope(overload->metrics());
+#endif
+                return reinterpret_cast<GenericFunction::trampoline_t<R, void *, Ts...>>(trampoline)(storage, instance, std::forward<Ts>(args)...);
+            }
+        };
+
+        template <typename C>
+        static constexpr Qualifier qualifierFor() noexcept
+        {
+            return std::is_const_v<C> ? Qualifier::Immutable : Qualifier::Mutable;
+        }
+
+        template <typename R, typename... Ts>
+        std::optional<Failure> check(const Overload *found) const noexcept
+        {
+            if (!found)
+                return Failure(Error::UnknownSignature, _name, nullptr, nullptr, &utility::signatureString<Ts...>);
+
+            if (utility::typeId<R>() != found->_returnTypeId)
+                return Failure(Error::InvalidMethodType, _name, typeid(R).name(), found->_returnType.name());
+
+            return std::nullopt;
+        }
+
+        const Overload &dynamicOverload(std::span<const Value> arguments, Qualifier qualifier) const
+        {
+            if (auto found = findValueOverload(Value::signatureHash(arguments), arguments.size(), qualifier))
+                return *found;
+
+            throw unknown_method("unknown signature " + name() + "(" + Value::signatureString(arguments) + ") for method " + name());
+        }
+
+        // Overload whose argument types without cv- and reference qualifiers are Ts, for arguments passed by value
+        template <typename... Ts>
+        const Overload *findValueOverload(Qualifier qualifier) const noexcept
+        {
+            if constexpr ((std::is_same_v<Ts, std::remove_cvref_t<Ts>> && ...))
+                return findValueOverload(utility::signatureHash<Ts...>(), sizeof...(Ts), qualifier);
+            else
+                return nullptr;
+        }
+
+        template <typename... Ts>
+        const Overload &valueOverload(Qualifier qualifier) const
+        {
+            if (auto found = findValueOverload<Ts...>(qualifier))
+                return *found;
+
+            throw unknown_method("unknown signature " + name() + "(" + utility::signatureString<Ts...>() + ") for method " + name());
+        }
+
+        // Hash as in Overload::valueSignature, count disambiguates collisions
+        const Overload *findValueOverload(std::size_t hash, std::size_t count, Qualifier qualifier) const noexcept
+        {
+            const auto matches = [&](const Overload &overload) {
+                return overload._valueSignature == hash && overload._argumentTypes.size() == count;
+            };
+
+            if (auto found = _overloads.find({hash, qualifier}); found && matches(*found))
+                return found;
+            else if (qualifier == Qualifier::Mutable) // const methods can be called on non-const objects
+                if (auto found = _overloads.find({hash, Qualifier::Immutable}); found && matches(*found))
+                    return found;
+
+            const Overload *found = nullptr;
+            _overloads.forEach([&](const Overload &overload) {
+                if (!matches(overload))
+                    return;
+
+                if (overload._qualifier == qualifier)
+                    found = &overload;
+                else if (!found && qualifier == Qualifier::Mutable && overload._qualifier == Qualifier::Immutable)
+                    found = &overload;
+            });
+
+            return found;
+        }
+
         struct overload_index
         {
             std::size_t hash;
@@ -184,6 +573,118 @@ namespace lh::reflection
         };
 
         std::string _name;
-        std::unordered_map<overload_index, Overload, overload_index_hash, overload_index_equal> _overloads;
+        utility::sealable_map<overload_index, Overload, overload_index_hash, overload_index_equal> _overloads;
+        utility::sealable_map<overload_index, Record, overload_index_hash, overload_index_equal> _records; // filled by seal
+    };
+
+    template <typename R, typename... Ts>
+    class MethodHandle final
+    {
+        friend class Method;
+
+        using trampoline_t = GenericFunction::trampoline_t<R, void *, Ts...>;
+
+        explicit MethodHandle(const Method::Overload &overload, Method::Qualifier qualifier) noexcept :
+            _trampoline(overload._function.template trampoline<R, void *, Ts...>()),
+            _storage(overload._function.storage()),
+            _qualifier(qualifier)
+#ifdef REFLECTION_METRICS
+            , _metrics(&overload._metrics)
+#endif
+        {
+        }
+
+        // A handle keeps the qualifier it was resolved for: only static handles are called without an
+        // instance, and mutable handles are never called on const instances
+        template <typename C>
+        void check() const
+        {
+            if constexpr (std::is_const_v<C>)
+                if (_qualifier == Method::Qualifier::Mutable) [[unlikely]]
+                    throw invalid_method_type("mutable method handle called on a const instance");
+        }
+
+    public:
+        MethodHandle() noexcept = default;
+
+        explicit operator bool() const noexcept { return _trampoline != nullptr; }
+
+        template <typename C>
+        R invoke(C *instance, Ts... args) const
+        {
+            check<C>();
+
+#ifdef REFLECTION_METRICS
+            const Metrics::Scope scope(*_metrics);
+#endif
+            return _trampoline(_storage, const_cast<void *>(static_cast<const void *>(instance)), std::forward<Ts>(args)...);
+        }
+
+        R invoke(Ts... args) const
+        {
+            if (_qualifier != Method::Qualifier::Static) [[unlikely]]
+                throw invalid_method_type("member method handle called without an instance");
+
+#ifdef REFLECTION_METRICS
+            const Metrics::Scope scope(*_metrics);
+#endif
+            return _trampoline(_storage, nullptr, std::forward<Ts>(args)...);
+        }
+
+        template <typename C>
+        void invokeAll(std::span<C *> instances, Ts... args) const
+        {
+            check<C>();
+
+#ifdef REFLECTION_METRICS
+            _metrics->count(instances.size());
+#endif
+            for (auto instance : instances)
+                _trampoline(_storage, const_cast<void *>(static_cast<const void *>(instance)), args...);
+        }
+
+        template <typename C>
+            requires(!std::is_void_v<R>)
+        void invokeAll(std::span<C *> instances, std::span<R> results, Ts... args) const
+        {
+            if (results.size() < instances.size())
+                throw invalid_method_type("results span of size " + std::to_string(results.size()) + " is shorter than " + std::to_string(instances.size()) + " instances");
+
+            check<C>();
+
+#ifdef REFLECTION_METRICS
+            _metrics->count(instances.size());
+#endif
+            for (std::size_t i = 0; i < instances.size(); ++i)
+                results[i] = _trampoline(_storage, const_cast<void *>(static_cast<const void *>(instances[i])), args...);
+        }
+
+        template <typename C>
+        void invokeAll(ThreadPool &pool, std::size_t grain, std::span<C *> instances, Ts... args) const
+        {
+            pool.parallelFor(instances.size(), grain, [&](std::size_t begin, std::size_t end) {
+                invokeAll(instances.subspan(begin, end - begin), args...);
+            });
+        }
+
+        template <typename C>
+            requires(!std::is_void_v<R>)
+        void invokeAll(ThreadPool &pool, std::size_t grain, std::span<C *> instances, std::span<R> results, Ts... args) const
+        {
+            if (results.size() < instances.size())
+                throw invalid_method_type("results span of size " + std::to_string(results.size()) + " is shorter than " + std::to_string(instances.size()) + " instances");
+
+            pool.parallelFor(instances.size(), grain, [&](std::size_t begin, std::size_t end) {
+                invokeAll(instances.subspan(begin, end - begin), results.subspan(begin, end - begin), args...);
+            });
+        }
+
+    private:
+        trampoline_t _trampoline = nullptr;
+        const void *_storage = nullptr;
+        Method::Qualifier _qualifier = Method::Qualifier::Static;
+#ifdef REFLECTION_METRICS
+        const Metrics *_metrics = nullptr;
+#endif
     };
 }
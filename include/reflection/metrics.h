@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#include "reflection/utility.h"
+
+namespace lh::reflection
+{
+    // Call counts and sampled latencies of one reflected member. Members only carry metrics when built
+    // with REFLECTION_METRICS, and record them only while enabled at runtime. The counters are spread
+    // over shards picked per thread, so that threads calling the same member rarely share a cache line,
+    // and are allocated on the first recorded call.
+    class Metrics final : private utility::non_copyable
+    {
+        struct Shard;
+
+    public:
+        // Latencies in nanoseconds fall into four linear buckets per power of two
+        static constexpr std::size_t buckets = 128;
+        static constexpr std::size_t shards = 8;
+
+        struct Snapshot
+        {
+            std::uint64_t calls = 0;
+            std::uint64_t samples = 0;
+            std::uint64_t nanoseconds = 0;
+            std::array<std::uint64_t, buckets> histogram{};
+
+            static std::size_t bucket(std::uint64_t nanoseconds) noexcept;
+
+            // Smallest latency that falls into the bucket
+            static std::uint64_t lowerBound(std::size_t bucket) noexcept;
+
+            // Lower bound of the bucket below which the fraction of the samples fall
+            std::uint64_t percentile(double fraction) const noexcept;
+        };
+
+        // Counts one call and times it if it is sampled
+        class Scope final : private utility::non_copyable
+        {
+        public:
+            explicit Scope(const Metrics &metrics) noexcept
+            {
+                if (enabled()) [[unlikely]]
+                    _shard = metrics.begin(_start);
+            }
+
+            ~Scope()
+            {
+                if (_start) [[unlikely]]
+                    end(_shard, _start);
+            }
+
+        private:
+            Shard *_shard = nullptr;
+            std::int64_t _start = 0;
+        };
+
+        Metrics() noexcept = default;
+        Metrics(Metrics &&other) noexcept;
+        Metrics &operator=(Metrics &&other) noexcept;
+        ~Metrics();
+
+        static void enable(bool enabled) noexcept;
+        static bool enabled() noexcept { return _enabled.load(std::memory_order_relaxed); }
+
+        // Times every nth call on each thread, or none if 0
+        static void sample(std::uint32_t every) noexcept;
+
+        // Counts calls made in bulk, without timing them
+        void count(std::uint64_t calls) const noexcept
+        {
+            if (enabled()) [[unlikely]]
+                add(calls);
+        }
+
+        Snapshot snapshot() const noexcept;
+        void reset() const noexcept;
+
+        // Heap bytes of the shards, 0 until the first call is recorded
+        std::size_t allocated() const noexcept;
+
+    private:
+        Shard *begin(std::int64_t &start) const noexcept;
+        static void end(Shard *shard, std::int64_t start) noexcept;
+        void add(std::uint64_t calls) const noexcept;
+        Shard *shard() const noexcept;
+
+        static std::atomic<bool> _enabled;
+        mutable std::atomic<Shard *> _shards = nullptr;
+    };
+
+    // Metrics of one member of a registered type, see Library::metrics
+    struct MemberMetrics
+    {
+        enum class Kind
+        {
+            Method,
+            Property,
+            Event
+        };
+
+        std::string type;
+        std::string member;
+        Kind kind;
+
+        // Argument types of a method overload, or the type of a property or event
+        std::string signature;
+
+        Metrics::Snapshot metrics;
+    };
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <cstdint>
+
+namespace lh::reflection::utility
+{
+    // Collision-free mapping from a fixed set of 64-bit key hashes to slots, built with hash and displace:
+    // keys are grouped into small buckets, and every bucket gets a displacement that moves all of its keys
+    // to free slots. Looking up a slot costs one displacement load and one mix. Keys outside the set map
+    // to arbitrary slots, so callers have to compare the key stored in the slot.
+    class perfect_hash
+    {
+    public:
+        perfect_hash() noexcept = default;
+        explicit perfect_hash(std::span<const std::uint64_t> hashes);
+
+        bool empty() const noexcept { return _displacements.empty(); }
+        std::size_t slots() const noexcept { return empty() ? 0 : _mask + 1; }
+
+        std::size_t slot(std::uint64_t hash) const noexcept
+        {
+            return slot(hash, _displacements, _mask);
+        }
+
+        // The table is fully described by its displacements and mask, which lets it be stored elsewhere
+        // (see SchemaSnapshot) and looked up in place
+        std::span<const std::uint64_t> displacements() const noexcept { return _displacements; }
+        std::uint64_t mask() const noexcept { return _mask; }
+
+        static std::size_t slot(std::uint64_t hash, std::span<const std::uint64_t> displacements, std::uint64_t mask) noexcept
+        {
+            return static_cast<std::size_t>(mix(hash ^ displacements[bucket(hash, displacements.size())]) & mask);
+        }
+
+    private:
+        static constexpr std::uint64_t mix(std::uint64_t value) noexcept
+        {
+            value ^= value >> 33;
+            value *= 0xff51afd7ed558ccd;
+            value ^= value >> 33;
+            value *= 0xc4ceb9fe1a85ec53;
+            value ^= value >> 33;
+            return value;
+        }
+
+        static std::size_t bucket(std::uint64_t hash, std::size_t buckets) noexcept
+        {
+            return static_cast<std::size_t>(((hash >> 32) * buckets) >> 32);
+        }
+
+        bool build(std::span<const std::uint64_t> hashes, std::size_t slots);
+
+        std::vector<std::uint64_t> _displacements;
+        std::uint64_t _mask = 0;
+    };
+}
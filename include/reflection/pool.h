@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <memory_resource>
+
+#include "reflection/metaobject.h"
+#include "reflection/exceptions.h"
+
+namespace lh::reflection
+{
+    // Recycles instances of one MetaObject through a free list of blocks sized for its instances, so that
+    // acquiring an instance costs a pop and a constructor call once the pool is warm. Blocks are taken
+    // from the upstream resource in chunks of growing size and only returned when the pool is destroyed.
+    // Not synchronized, every instance must be recycled before the pool is destroyed.
+    class Pool final : private utility::non_copyable
+    {
+    public:
+        explicit Pool(const MetaObject &metaObject, std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+        ~Pool();
+
+        template <typename R, typename... Ts>
+        R *acquire(Ts... args)
+        {
+            auto block = take();
+
+            try
+            {
+                return _metaObject.constructAt<R>(block, args...);
+            }
+            catch (...)
+            {
+                give(block);
+                throw;
+            }
+        }
+
+        void recycle(void *instance) noexcept
+        {
+            _metaObject.destruct(instance);
+            give(instance);
+        }
+
+        std::size_t available() const noexcept { return _available; }
+        std::size_t capacity() const noexcept { return _capacity; }
+
+    private:
+        struct Node
+        {
+            Node *next;
+        };
+
+        void *take()
+        {
+            if (!_free)
+                grow();
+
+            --_available;
+            return std::exchange(_free, _free->next);
+        }
+
+        void give(void *block) noexcept
+        {
+            _free = ::new (block) Node{_free};
+            ++_available;
+        }
+
+        void grow();
+
+        const MetaObject &_metaObject;
+        std::pmr::memory_resource *_upstream;
+
+        std::size_t _blockSize;
+        std::size_t _blockAlignment;
+
+        Node *_free = nullptr;
+        std::size_t _available = 0;
+        std::size_t _capacity = 0;
+        std::vector<std::pair<void *, std::size_t>> _chunks;
+    };
+}
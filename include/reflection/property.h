@@ -1,53 +1,489 @@
 #pragma once
 
+#include <new>
+#include <span>
 #include <string>
+#include <cstring>
 #include <vector>
+#include <optional>
 #include <typeindex>
 
 #include "reflection/utility.h"
 #include "reflection/function.h"
+#include "reflection/metrics.h"
+#include "reflection/memory_usage.h"
+#include "reflection/result.h"
 #include "reflection/exceptions.h"
 
 namespace lh::reflection
 {
+    template <typename T>
+    class PropertyHandle;
+
+    // Placement of a property backed by a data member within the instances passed to it
+    struct FieldLayout
+    {
+        std::size_t offset;
+        std::size_t size;
+        std::size_t alignment;
+        bool triviallyCopyable;
+    };
+
     class Property final : private utility::non_copyable
     {
     public:
-        template <typename C, typename T>
-        explicit Property(std::string name, std::function<T(const C *)> getter, std::function<void(C *, T)> setter) noexcept :
+        // Instances are passed to the stored accessors as void *, see Method::Overload. The bulk
+        // accessors loop over the stored getter and setter themselves, so when those are stored inline
+        // they get inlined into the loop. Getters returning a reference are stored as returning a const
+        // reference, setters are always passed an rvalue reference, so values are moved down to them.
+        template <typename C, typename R, typename G, typename S, typename T = std::remove_cvref_t<R>, typename Get = std::conditional_t<std::is_reference_v<R>, const T &, T>>
+        explicit Property(std::string name, G getter, S setter, std::type_identity<R(const C *)>) :
             _name(name),
             _type(typeid(T)),
-            _getter(std::make_unique<SpecificFunction<T, const C *>>(getter)),
-            _setter(std::make_unique<SpecificFunction<void, C *, T>>(setter))
+            _typeId(utility::typeId<T>()),
+            _getter(SpecificFunction<Get, const void *>(bound_getter<C, Get, G>{std::move(getter)})),
+            _setter(SpecificFunction<void, void *, T &&>(bound_setter<C, T, S>{std::move(setter)})),
+            _gather(reinterpret_cast<void (*)()>(&gatherAll<T, typename SpecificFunction<Get, const void *>::template stored_t<bound_getter<C, Get, G>>>)),
+            _scatter(reinterpret_cast<void (*)()>(&scatterAll<T, typename SpecificFunction<void, void *, T &&>::template stored_t<bound_setter<C, T, S>>>)),
+            _reference(std::is_reference_v<R>)
         {
         }
 
+        // Property backed by a data member. Accessors read and write the member in place at its offset,
+        // the getter and setter only serve handles and bulk accessors of non-field properties.
+        template <typename C, typename T>
+        explicit Property(std::string name, T C::*member) :
+            Property(std::move(name),
+                [member](const C *instance) -> const T & { return instance->*member; },
+                [member](C *instance, T &&value) { instance->*member = std::move(value); },
+                std::type_identity<const T &(const C *)>())
+        {
+            _field = FieldLayout{utility::memberOffset(member), sizeof(T), alignof(T), std::is_trivially_copyable_v<T>};
+        }
+
         std::string name() const noexcept { return _name; }
         std::type_index type() const noexcept { return _type; }
-        std::size_t hash() const noexcept { return _type.hash_code(); }
+        std::size_t hash() const noexcept { return _typeId; }
+
+        // Set if the property was registered from a pointer to data member
+        const std::optional<FieldLayout> &layout() const noexcept { return _field; }
 
+        // Set if the getter returns a reference into the instance, or the property is a data member, so
+        // that it can be read by const reference or as a view without copying it
+        bool byReference() const noexcept { return _reference; }
+
+        // T is the type of the property, a const reference to it or, for std::string and std::vector
+        // properties, a std::string_view or std::span<const E>. References and views are only handed out
+        // by properties read byReference(), they are valid as long as the member they refer to.
         template <typename C, typename T>
         T get(const C *instance) const
         {
-            if (typeid(T).hash_code() != hash())
+            if (!readable<T>())
+            {
+                if (!_reference && (std::is_reference_v<T> || utility::is_view_v<T>))
+                    throw invalid_property_type("getter of property " + name() + " returns " + std::string(type().name()) + " by value, type " + std::string(typeid(T).name()) + " cannot refer to it");
+
                 throw invalid_property_type("type " + std::string(typeid(T).name()) + " is incompatible with type " + std::string(type().name()) + " for getter of property " + name());
+            }
 
-            return _getter->invoke<T>(instance);
+#ifdef REFLECTION_METRICS
+            const Metrics::Scope scope(_metrics);
+#endif
+            return read<T>(static_cast<const void *>(instance));
         }
 
+        // Rvalues are moved through to the setter, or into the member of a data member property
         template <typename C, typename T>
         void set(C *instance, T value) const
         {
-            if (typeid(T).hash_code() != hash())
+            if (utility::typeId<T>() != hash())
                 throw invalid_property_type("type " + std::string(typeid(T).name()) + " is incompatible with type " + std::string(type().name()) + " for setter of property " + name());
 
-            _setter->invoke<void>(instance, value);
+#ifdef REFLECTION_METRICS
+            const Metrics::Scope scope(_metrics);
+#endif
+            write(const_cast<void *>(static_cast<const void *>(instance)), std::move(value));
+        }
+
+        // Like get and set, but return a failure instead of throwing on a type mismatch
+        template <typename C, typename T>
+        Result<T> tryGet(const C *instance) const
+        {
+            if (!readable<T>())
+                return mismatch<T>();
+
+#ifdef REFLECTION_METRICS
+            const Metrics::Scope scope(_metrics);
+#endif
+            return read<T>(static_cast<const void *>(instance));
+        }
+
+        template <typename C, typename T>
+        Result<void> trySet(C *instance, T value) const
+        {
+            if (utility::typeId<T>() != hash())
+                return mismatch<T>();
+
+#ifdef REFLECTION_METRICS
+            const Metrics::Scope scope(_metrics);
+#endif
+            write(const_cast<void *>(static_cast<const void *>(instance)), std::move(value));
+            return {};
+        }
+
+        // Reads the property of every instance into the matching element of values
+        template <typename C, typename T>
+        void gather(std::span<const C *const> instances, std::span<T> values) const
+        {
+            checkColumn<T>(instances.size(), values.size(), "gather");
+#ifdef REFLECTION_METRICS
+            _metrics.count(instances.size());
+#endif
+            gatherColumn<T>(instances.data(), 0, true, values.data(), sizeof(T), instances.size());
+        }
+
+        template <typename C, typename T>
+        void gather(std::span<const C> instances, std::span<T> values) const
+        {
+            checkColumn<T>(instances.size(), values.size(), "gather");
+#ifdef REFLECTION_METRICS
+            _metrics.count(instances.size());
+#endif
+            gatherColumn<T>(instances.data(), sizeof(C), false, values.data(), sizeof(T), instances.size());
+        }
+
+        // Writes every element of values into the property of the matching instance
+        template <typename C, typename T>
+        void scatter(std::span<C *const> instances, std::span<const T> values) const
+        {
+            checkColumn<T>(instances.size(), values.size(), "scatter");
+#ifdef REFLECTION_METRICS
+            _metrics.count(instances.size());
+#endif
+            scatterColumn<T>(const_cast<C **>(instances.data()), 0, true, values.data(), instances.size());
+        }
+
+        template <typename C, typename T>
+        void scatter(std::span<C> instances, std::span<const T> values) const
+        {
+            checkColumn<T>(instances.size(), values.size(), "scatter");
+#ifdef REFLECTION_METRICS
+            _metrics.count(instances.size());
+#endif
+            scatterColumn<T>(instances.data(), sizeof(C), false, values.data(), instances.size());
+        }
+
+        // T is the type of the property or, for properties read byReference(), a const reference to it
+        template <typename T>
+        PropertyHandle<T> handle() const
+        {
+            if (utility::typeId<std::remove_cvref_t<T>>() != hash() || (std::is_reference_v<T> && !_reference))
+                throw invalid_property_type("type " + std::string(typeid(T).name()) + " is incompatible with type " + std::string(type().name()) + " of property " + name());
+
+            return PropertyHandle<T>(*this);
+        }
+
+#ifdef REFLECTION_METRICS
+        const Metrics &metrics() const noexcept { return _metrics; }
+#endif
+
+        // Heap memory held by the property beyond its own size
+        MemoryUsage memoryUsage() const noexcept
+        {
+            MemoryUsage usage;
+            usage.names = utility::heapSize(_name);
+            usage.captures = _getter.allocated() + _setter.allocated();
+#ifdef REFLECTION_METRICS
+            usage.metrics = _metrics.allocated();
+#endif
+            return usage;
         }
 
     private:
+        friend class Serializer;
+
+        template <typename T>
+        friend class PropertyHandle;
+
+        // Instances are either an array of pointers (indirect) or an array of objects stride bytes apart.
+        // Gathered values are written valueStride bytes apart, which only trivially copyable types allow
+        // to differ from sizeof(T); the Serializer uses that to interleave properties into records.
+        template <typename T>
+        using gather_t = void (*)(const void *getter, const void *instances, std::size_t stride, bool indirect, void *values, std::size_t valueStride, std::size_t count);
+
+        template <typename T>
+        using scatter_t = void (*)(const void *setter, void *instances, std::size_t stride, bool indirect, const T *values, std::size_t count);
+
+        template <typename C, typename R, typename G>
+        struct bound_getter
+        {
+            R operator()(const void *instance) { return std::invoke(getter, static_cast<const C *>(instance)); }
+            G getter;
+        };
+
+        template <typename C, typename T, typename S>
+        struct bound_setter
+        {
+            void operator()(void *instance, T &&value) { std::invoke(setter, static_cast<C *>(instance), std::move(value)); }
+            S setter;
+        };
+
+        template <typename T, typename F>
+        static void gatherAll(const void *getter, const void *instances, std::size_t stride, bool indirect, void *values, std::size_t valueStride, std::size_t count)
+        {
+            auto &fn = *static_cast<F *>(const_cast<void *>(getter));
+
+            auto put = [target = static_cast<unsigned char *>(values), valueStride](std::size_t i, auto &&value) {
+                if constexpr (std::is_trivially_copyable_v<T>)
+                    std::memcpy(target + i * valueStride, &value, sizeof(T));
+                else
+                    reinterpret_cast<T *>(target)[i] = std::forward<decltype(value)>(value);
+            };
+
+            if (indirect)
+            {
+                auto pointers = static_cast<const void *const *>(instances);
+                for (std::size_t i = 0; i < count; ++i)
+                    put(i, fn(pointers[i]));
+            }
+            else
+            {
+                auto bytes = static_cast<const unsigned char *>(instances);
+                for (std::size_t i = 0; i < count; ++i)
+                    put(i, fn(bytes + i * stride));
+            }
+        }
+
+        template <typename T, typename F>
+        static void scatterAll(const void *setter, void *instances, std::size_t stride, bool indirect, const T *values, std::size_t count)
+        {
+            auto &fn = *static_cast<F *>(const_cast<void *>(setter));
+
+            if (indirect)
+            {
+                auto pointers = static_cast<void *const *>(instances);
+                for (std::size_t i = 0; i < count; ++i)
+                    fn(pointers[i], T(values[i]));
+            }
+            else
+            {
+                auto bytes = static_cast<unsigned char *>(instances);
+                for (std::size_t i = 0; i < count; ++i)
+                    fn(bytes + i * stride, T(values[i]));
+            }
+        }
+
+        template <typename T>
+        gather_t<T> gatherer() const noexcept { return reinterpret_cast<gather_t<T>>(_gather); }
+
+        template <typename T>
+        scatter_t<T> scatterer() const noexcept { return reinterpret_cast<scatter_t<T>>(_scatter); }
+
+        // Field of a property registered from a pointer to data member, the type has been checked
+        template <typename T>
+        const T *at(const void *instance) const noexcept
+        {
+            return std::launder(reinterpret_cast<const T *>(static_cast<const unsigned char *>(instance) + _field->offset));
+        }
+
+        template <typename T>
+        T *at(void *instance) const noexcept
+        {
+            return std::launder(reinterpret_cast<T *>(static_cast<unsigned char *>(instance) + _field->offset));
+        }
+
+        // Fields are copied straight out of the instances, trivially copyable ones with fixed size memcpy
+        // that compiles to plain loads and stores
+        template <typename T>
+        void gatherColumn(const void *instances, std::size_t stride, bool indirect, void *values, std::size_t valueStride, std::size_t count) const
+        {
+            if (!_field)
+                return gatherer<T>()(_getter.storage(), instances, stride, indirect, values, valueStride, count);
+
+            auto target = static_cast<unsigned char *>(values);
+            auto put = [&](std::size_t i, const void *instance) {
+                if constexpr (std::is_trivially_copyable_v<T>)
+                    std::memcpy(target + i * valueStride, at<T>(instance), sizeof(T));
+                else
+                    reinterpret_cast<T *>(target)[i] = *at<T>(instance);
+            };
+
+            if (indirect)
+            {
+                auto pointers = static_cast<const void *const *>(instances);
+                for (std::size_t i = 0; i < count; ++i)
+                    put(i, pointers[i]);
+            }
+            else
+            {
+                auto bytes = static_cast<const unsigned char *>(instances);
+                for (std::size_t i = 0; i < count; ++i)
+                    put(i, bytes + i * stride);
+            }
+        }
+
+        template <typename T>
+        void scatterColumn(void *instances, std::size_t stride, bool indirect, const T *values, std::size_t count) const
+        {
+            if (!_field)
+                return scatterer<T>()(_setter.storage(), instances, stride, indirect, values, count);
+
+            if (indirect)
+            {
+                auto pointers = static_cast<void *const *>(instances);
+                for (std::size_t i = 0; i < count; ++i)
+                    *at<T>(pointers[i]) = values[i];
+            }
+            else
+            {
+                auto bytes = static_cast<unsigned char *>(instances);
+                for (std::size_t i = 0; i < count; ++i)
+                    *at<T>(bytes + i * stride) = values[i];
+            }
+        }
+
+        template <typename T>
+        bool readable() const noexcept
+        {
+            static_assert(!std::is_reference_v<T> || std::is_const_v<std::remove_reference_t<T>>, "properties can only be read by const reference");
+
+            if constexpr (std::is_reference_v<T>)
+                return utility::typeId<std::remove_cvref_t<T>>() == hash() && _reference;
+            else if constexpr (utility::is_view_v<T>)
+                return utility::typeId<T>() == hash() || (utility::typeId<utility::view_source_t<T>>() == hash() && _reference);
+            else
+                return utility::typeId<T>() == hash();
+        }
+
+        // Reads the property as checked by readable, without copying for references and views
+        template <typename T>
+        T read(const void *instance) const
+        {
+            using V = std::remove_cvref_t<T>;
+
+            if constexpr (utility::is_view_v<T>)
+            {
+                if (utility::typeId<T>() != hash())
+                    return T(read<const utility::view_source_t<T> &>(instance));
+            }
+
+            if (_field)
+                return *at<V>(instance);
+
+            if constexpr (std::is_reference_v<T>)
+                return _getter.invoke<const V &>(instance);
+            else if (_reference)
+                return _getter.invoke<const V &>(instance);
+            else
+                return _getter.invoke<V>(instance);
+        }
+
+        template <typename T>
+        void write(void *instance, T &&value) const
+        {
+            if (_field)
+                *at<T>(instance) = std::move(value);
+            else
+                _setter.invoke<void, void *, T &&>(instance, std::move(value));
+        }
+
+        template <typename T>
+        Failure mismatch() const noexcept
+        {
+            return Failure(Error::InvalidPropertyType, _name, typeid(T).name(), _type.name());
+        }
+
+        template <typename T>
+        void checkColumn(std::size_t instances, std::size_t values, const char *operation) const
+        {
+            if (utility::typeId<T>() != hash())
+                throw invalid_property_type("type " + std::string(typeid(T).name()) + " is incompatible with type " + std::string(type().name()) + " for " + operation + " of property " + name());
+
+            if (values < instances)
+                throw reflection_error("column of " + std::to_string(values) + " values is too short for " + std::to_string(instances) + " instances to " + operation + " property " + name());
+        }
+
         std::string _name;
         std::type_index _type;
-        std::unique_ptr<GenericFunction> _getter;
-        std::unique_ptr<GenericFunction> _setter;
+        std::size_t _typeId;
+        GenericFunction _getter;
+        GenericFunction _setter;
+        void (*_gather)();
+        void (*_scatter)();
+        std::optional<FieldLayout> _field;
+        bool _reference;
+#ifdef REFLECTION_METRICS
+        Metrics _metrics;
+#endif
+    };
+
+    template <typename T>
+    class PropertyHandle final
+    {
+        friend class Property;
+
+        using value_t = std::remove_cvref_t<T>;
+        using getter_t = GenericFunction::trampoline_t<value_t, const void *>;
+        using reference_getter_t = GenericFunction::trampoline_t<const value_t &, const void *>;
+        using setter_t = GenericFunction::trampoline_t<void, void *, value_t &&>;
+
+        explicit PropertyHandle(const Property &property) noexcept :
+            _getter(reinterpret_cast<void (*)()>(property._getter.trampoline<value_t, const void *>())),
+            _getterStorage(property._getter.storage()),
+            _setter(property._setter.trampoline<void, void *, value_t &&>()),
+            _setterStorage(property._setter.storage()),
+            _offset(property._field ? static_cast<std::ptrdiff_t>(property._field->offset) : -1),
+            _reference(property._reference)
+#ifdef REFLECTION_METRICS
+            , _metrics(&property._metrics)
+#endif
+        {
+        }
+
+    public:
+        PropertyHandle() noexcept = default;
+
+        explicit operator bool() const noexcept { return _getter != nullptr; }
+
+        template <typename C>
+        T get(const C *instance) const
+        {
+#ifdef REFLECTION_METRICS
+            const Metrics::Scope scope(*_metrics);
+#endif
+            if (_offset >= 0)
+                return *std::launder(reinterpret_cast<const value_t *>(reinterpret_cast<const unsigned char *>(instance) + _offset));
+
+            if constexpr (std::is_reference_v<T>)
+                return reinterpret_cast<reference_getter_t>(_getter)(_getterStorage, instance);
+            else if (_reference)
+                return reinterpret_cast<reference_getter_t>(_getter)(_getterStorage, instance);
+            else
+                return reinterpret_cast<getter_t>(_getter)(_getterStorage, instance);
+        }
+
+        template <typename C>
+        void set(C *instance, value_t value) const
+        {
+#ifdef REFLECTION_METRICS
+            const Metrics::Scope scope(*_metrics);
+#endif
+            if (_offset >= 0)
+                *std::launder(reinterpret_cast<value_t *>(reinterpret_cast<unsigned char *>(instance) + _offset)) = std::move(value);
+            else
+                _setter(_setterStorage, instance, std::move(value));
+        }
+
+    private:
+        // Getter returning either value_t or a const reference to it, see Property::byReference
+        void (*_getter)() = nullptr;
+        const void *_getterStorage = nullptr;
+        setter_t _setter = nullptr;
+        const void *_setterStorage = nullptr;
+        std::ptrdiff_t _offset = -1;
+        bool _reference = false;
+#ifdef REFLECTION_METRICS
+        const Metrics *_metrics = nullptr;
+#endif
     };
 }
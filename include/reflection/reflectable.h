@@ -1,12 +1,13 @@
 #pragma once
 
+#include <span>
 #include <string>
-#include <map>
+#include <string_view>
 #include <vector>
-#include <optional>
 #include <functional>
 
 #include "reflection/metaobject.h"
+#include "reflection/event_bus.h"
 
 namespace lh::reflection
 {
@@ -14,80 +15,184 @@ namespace lh::reflection
     {
     public:
         Reflectable() noexcept = default;
+        virtual ~Reflectable() = default;
 
         Reflectable(const Reflectable &) noexcept {}
-        Reflectable(Reflectable &&other) noexcept : _subscriptions(std::move(other._subscriptions)) {}
+        Reflectable(Reflectable &&other) noexcept : _subscriptions(std::move(other._subscriptions)), _eventBus(other._eventBus) {}
 
         Reflectable &operator=(const Reflectable &) noexcept { return *this; }
         Reflectable &operator=(Reflectable &&) noexcept { return *this; }
 
-        static const MetaObject &staticMetaObject() noexcept { return _metaObject; };
-        virtual const MetaObject &metaObject() const noexcept { return _metaObject; };
+        // Built on first use rather than during static initialization
+        static const MetaObject &staticMetaObject() noexcept
+        {
+            static MetaObject metaObject("Reflectable", typeid(Reflectable));
+            return metaObject;
+        }
+
+        virtual const MetaObject &metaObject() const noexcept { return staticMetaObject(); }
 
         template <typename T>
-        T get(std::string propertyName) const
+        T get(std::string_view propertyName) const
         {
             return metaObject().property(propertyName).get<Reflectable, T>(this);
         }
 
         template <typename T>
-        void set(std::string propertyName, T value)
+        void set(std::string_view propertyName, T value)
         {
-            metaObject().property(propertyName).set(this, value);
+            metaObject().property(propertyName).set(this, std::move(value));
         }
 
         template <typename R = void, typename... Ts>
-        R invoke(std::string methodName, Ts... args)
+        R invoke(std::string_view methodName, Ts... args)
         {
             return metaObject().method(methodName).invoke<R, Reflectable, Ts...>(this, args..., Method::Qualifier::Mutable);
         }
 
         template <typename R = void, typename... Ts>
-        R invoke(std::string methodName, Ts... args) const
+        R invoke(std::string_view methodName, Ts... args) const
         {
             return metaObject().method(methodName).invoke<R, const Reflectable, Ts...>(this, args..., Method::Qualifier::Immutable);
         }
 
+        // Non-throwing variants for probing members that may not exist, see Result. A miss neither
+        // allocates nor unwinds; exceptions thrown by the member itself still propagate.
+        template <typename T>
+        Result<T> tryGet(std::string_view propertyName) const
+        {
+            if (auto property = metaObject().findProperty(propertyName))
+                return property->tryGet<Reflectable, T>(this);
+
+            return Failure(Error::UnknownProperty, propertyName);
+        }
+
+        template <typename T>
+        Result<void> trySet(std::string_view propertyName, T value)
+        {
+            if (auto property = metaObject().findProperty(propertyName))
+                return property->trySet(this, std::move(value));
+
+            return Failure(Error::UnknownProperty, propertyName);
+        }
+
+        template <typename R = void, typename... Ts>
+        Result<R> tryInvoke(std::string_view methodName, Ts... args)
+        {
+            if (auto method = metaObject().findMethod(methodName))
+                return method->tryInvoke<R, Reflectable, Ts...>(this, args..., Method::Qualifier::Mutable);
+
+            return Failure(Error::UnknownMethod, methodName);
+        }
+
+        template <typename R = void, typename... Ts>
+        Result<R> tryInvoke(std::string_view methodName, Ts... args) const
+        {
+            if (auto method = metaObject().findMethod(methodName))
+                return method->tryInvoke<R, const Reflectable, Ts...>(this, args..., Method::Qualifier::Immutable);
+
+            return Failure(Error::UnknownMethod, methodName);
+        }
+
+        // For callers that only know the argument types at runtime, see Method::invokeDynamic
+        Value invokeDynamic(std::string_view methodName, std::span<Value> arguments)
+        {
+            return metaObject().method(methodName).invokeDynamic(this, arguments, Method::Qualifier::Mutable);
+        }
+
+        Value invokeDynamic(std::string_view methodName, std::span<Value> arguments) const
+        {
+            return metaObject().method(methodName).invokeDynamic(this, arguments, Method::Qualifier::Immutable);
+        }
+
         template <typename... Ts>
-        void event(std::string eventName, Ts... args) const
+        void event(std::string_view eventName, Ts... args) const
         {
-            if (!_subscriptions)
+            if (_subscriptions.empty())
                 return;
 
-            auto &event = metaObject().event(eventName);
-
-            if (auto where = _subscriptions->find(&event); where != _subscriptions->end())
-                for (const auto &subscription : where->second)
-                    event.invoke(subscription, args...);
+            event(metaObject().template eventHandle<Ts...>(eventName), args...);
         }
 
+        // Throws unknown_event before running any subscription if the handle belongs to a type this one
+        // does not inherit events from
         template <typename... Ts>
-        const Event::Subscription *subscribe(std::string eventName, std::function<void(Ts...)> eventHandler)
+        void event(const EventHandle<Ts...> &handle, std::type_identity_t<Ts>... args) const
+        {
+            // Events nobody subscribed to cost a bounds check and an empty check, before any lookup
+            if (handle.ordinal() >= _subscriptions.size())
+                return;
+
+            const auto &subscriptions = _subscriptions[handle.ordinal()];
+            if (subscriptions.empty())
+                return;
+
+            if (const auto &type = metaObject(); handle.owner() != &type)
+                checkEvent(type, handle.event(), handle.owner());
+
+#ifdef REFLECTION_METRICS
+            const Metrics::Scope scope(handle.event().metrics());
+#endif
+
+            if (_eventBus)
+            {
+                for (const auto &subscription : subscriptions)
+                    _eventBus->template post<Ts...>(handle.event(), subscription, args...);
+            }
+            else
+            {
+                for (const auto &subscription : subscriptions)
+                    handle.invoke(subscription, args...);
+            }
+        }
+
+        // Emits events through the bus instead of running subscriptions on the emitting thread,
+        // or synchronously again if null. The bus must outlive this object.
+        void setEventBus(EventBus *eventBus) noexcept { _eventBus = eventBus; }
+        EventBus *eventBus() const noexcept { return _eventBus; }
+
+        // The returned subscription stays valid until the subscriptions to this event change
+        template <typename F>
+        const Event::Subscription *subscribe(std::string_view eventName, F eventHandler)
         {
             auto &event = metaObject().event(eventName);
-            auto subscription = event.subscribe(eventHandler);
+            auto subscription = event.subscribe(std::move(eventHandler));
 
-            if (!_subscriptions)
-                _subscriptions = subscription_map();
+            if (_subscriptions.size() <= event.ordinal())
+                _subscriptions.resize(event.ordinal() + 1);
 
-            return &(*_subscriptions)[&event].emplace_back(std::move(subscription));
+            return &_subscriptions[event.ordinal()].emplace_back(std::move(subscription));
         }
 
-        void unsubscribe(std::string eventName, const Event::Subscription *subscription)
+        void unsubscribe(std::string_view eventName, const Event::Subscription *subscription)
         {
-            if (!_subscriptions)
+            if (_subscriptions.empty())
                 return;
 
-            auto &event = metaObject().event(eventName);
-            std::erase((*_subscriptions)[&event], *subscription);
+            if (auto ordinal = metaObject().event(eventName).ordinal(); ordinal < _subscriptions.size())
+                std::erase(_subscriptions[ordinal], *subscription);
         }
 
         void unsubscribe()
         {
-            if (!_subscriptions)
-                return;
+            _subscriptions.clear();
+        }
+
+        // Heap memory held by the subscriptions of this instance, the metadata of its type is reported
+        // by MetaObject::memoryUsage
+        MemoryUsage memoryUsage() const noexcept
+        {
+            MemoryUsage usage;
+            usage.subscriptions = utility::heapSize(_subscriptions);
+
+            for (const auto &subscriptions : _subscriptions)
+            {
+                usage.subscriptions += utility::heapSize(subscriptions) + subscriptions.size() * Event::Subscription::shared();
+                for (const auto &subscription : subscriptions)
+                    usage.captures += subscription.allocated();
+            }
 
-            _subscriptions.reset();
+            return usage;
         }
 
         virtual Reflectable *clone() const
@@ -95,16 +200,95 @@ namespace lh::reflection
             return new Reflectable(*this);
         }
 
+        // Copies this instance into memory from resource, to be destroyed with destroy(). Named apart from
+        // clone() so that overriding clone() does not hide it; derived classes override copier() instead.
+        Reflectable *cloneTo(std::pmr::memory_resource &resource) const
+        {
+            const auto &copy = copier();
+            auto where = resource.allocate(copy.size, copy.alignment);
+
+            try
+            {
+                return copy.construct(*this, where);
+            }
+            catch (...)
+            {
+                resource.deallocate(where, copy.size, copy.alignment);
+                throw;
+            }
+        }
+
+        // The clone is destroyed when the arena is released
+        Reflectable *cloneTo(utility::arena &arena) const
+        {
+            auto copy = cloneTo(static_cast<std::pmr::memory_resource &>(arena));
+
+            try
+            {
+                arena.adopt(copy);
+            }
+            catch (...)
+            {
+                std::destroy_at(copy);
+                throw;
+            }
+
+            return copy;
+        }
+
+        // Destroys a clone made by cloneTo and gives its memory back to the resource it came from
+        static void destroy(Reflectable *clone, std::pmr::memory_resource &resource)
+        {
+            const auto &copy = clone->copier();
+            std::destroy_at(clone);
+            resource.deallocate(clone, copy.size, copy.alignment);
+        }
+
         virtual std::size_t hash() const noexcept
         {
             return static_cast<std::size_t>(reinterpret_cast<std::uintptr_t>(this));
         }
 
+    protected:
+        // Layout and copy constructor of the dynamic type, for cloneTo and destroy
+        struct Copier
+        {
+            std::size_t size;
+            std::size_t alignment;
+            Reflectable *(*construct)(const Reflectable &original, void *where);
+        };
+
+        template <typename T>
+        static const Copier &copierOf() noexcept
+        {
+            static constexpr Copier copier{sizeof(T), alignof(T), [](const Reflectable &original, void *where) -> Reflectable * {
+                return ::new (where) T(static_cast<const T &>(original));
+            }};
+            return copier;
+        }
+
+        // Classes that can be cloned into memory return copierOf<T>() of themselves. Derived classes
+        // that do not are rejected rather than sliced.
+        virtual const Copier &copier() const
+        {
+            if (typeid(*this) != typeid(Reflectable))
+                throw instantiation_failed("clone of " + metaObject().name() + " would be sliced, it does not override copier()");
+
+            return copierOf<Reflectable>();
+        }
+
     private:
-        using subscription_map = std::map<const Event*, std::vector<Event::Subscription>>;
+        // Handles obtained from an Event directly have no owner, their event has to resolve by name
+        static void checkEvent(const MetaObject &type, const Event &event, const MetaObject *owner)
+        {
+            const bool inherited = owner ? type.isPrimarySubtypeOf(*owner) : type.findEvent(event.name()) == &event;
+            if (!inherited)
+                throw unknown_event("event " + event.name() + " of handle is not an event of " + type.name());
+        }
 
-        std::optional<subscription_map> _subscriptions;
-        static MetaObject _metaObject;
+        // Subscriptions per event ordinal, only as long as the highest ordinal subscribed to
+        std::vector<std::vector<Event::Subscription>> _subscriptions;
+        EventBus *_eventBus = nullptr;
     };
 }
 
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <variant>
+#include <memory>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+namespace lh::reflection
+{
+    enum class Error : std::uint8_t
+    {
+        UnknownType,
+        UnknownMethod,
+        UnknownSignature,
+        InvalidMethodType,
+        UnknownProperty,
+        InvalidPropertyType
+    };
+
+    // Why a non-throwing lookup or call failed. A failure only refers to a name, type names and the
+    // function formatting the requested signature, so that nothing is allocated or formatted unless
+    // message() or raise() is called. The name is either the one passed in by the caller or the one of
+    // the member, and has to outlive the failure.
+    class Failure final
+    {
+    public:
+        using signature_t = std::string (*)();
+
+        constexpr Failure(Error error, std::string_view name, const char *type = nullptr, const char *expected = nullptr, signature_t signature = nullptr) noexcept :
+            _error(error),
+            _name(name),
+            _type(type),
+            _expected(expected),
+            _signature(signature)
+        {
+        }
+
+        Error error() const noexcept { return _error; }
+        std::string_view name() const noexcept { return _name; }
+
+        // Text the matching exception is constructed with
+        std::string message() const;
+
+        // Throws the exception the throwing variant of the call would have thrown
+        [[noreturn]] void raise() const;
+
+    private:
+        Error _error;
+        std::string_view _name;
+        const char *_type;
+        const char *_expected;
+        signature_t _signature;
+    };
+
+    // Value of a non-throwing call or the Failure that prevented it. Exceptions thrown by the called
+    // function itself are not caught.
+    template <typename T>
+    class Result final
+    {
+        using stored_t = std::conditional_t<std::is_reference_v<T>, std::reference_wrapper<std::remove_reference_t<T>>, T>;
+
+    public:
+        Result(T value) noexcept(std::is_nothrow_move_constructible_v<stored_t>) :
+            _state(std::in_place_index<0>, std::forward<T>(value))
+        {
+        }
+
+        Result(Failure failure) noexcept :
+            _state(std::in_place_index<1>, failure)
+        {
+        }
+
+        bool hasValue() const noexcept { return _state.index() == 0; }
+        explicit operator bool() const noexcept { return hasValue(); }
+
+        // Raises the failure if there is no value
+        std::add_lvalue_reference_t<T> value() &
+        {
+            if (!hasValue())
+                error().raise();
+
+            return get();
+        }
+
+        T value() &&
+        {
+            if (!hasValue())
+                error().raise();
+
+            return std::forward<T>(get());
+        }
+
+        T valueOr(T fallback) &&
+        {
+            return hasValue() ? std::forward<T>(get()) : std::forward<T>(fallback);
+        }
+
+        std::add_lvalue_reference_t<T> operator*() noexcept { return get(); }
+        std::remove_reference_t<T> *operator->() noexcept { return std::addressof(get()); }
+
+        Failure error() const noexcept { return std::get<1>(_state); }
+
+    private:
+        std::add_lvalue_reference_t<T> get() noexcept
+        {
+            if constexpr (std::is_reference_v<T>)
+                return std::get<0>(_state).get();
+            else
+                return *std::get_if<0>(&_state);
+        }
+
+        std::variant<stored_t, Failure> _state;
+    };
+
+    template <>
+    class Result<void> final
+    {
+    public:
+        Result() noexcept = default;
+
+        Result(Failure failure) noexcept :
+            _failure(failure),
+            _failed(true)
+        {
+        }
+
+        bool hasValue() const noexcept { return !_failed; }
+        explicit operator bool() const noexcept { return hasValue(); }
+
+        void value() const
+        {
+            if (_failed)
+                _failure.raise();
+        }
+
+        Failure error() const noexcept { return _failure; }
+
+    private:
+        Failure _failure = Failure(Error::UnknownMethod, {});
+        bool _failed = false;
+    };
+}
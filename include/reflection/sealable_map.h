@@ -0,0 +1,145 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+
+namespace lh::reflection::utility
+{
+    // Hash map that can be sealed once populated. Sealing moves all values into one contiguous array and
+    // indexes them with an open-addressing table of (key, index) slots at a load factor of at most 1/2,
+    // so that a lookup usually reads one slot and one value. Sealing moves the values, which
+    // invalidates pointers and references obtained before.
+    template <typename K, typename V, typename Hash = std::hash<K>, typename Equal = std::equal_to<K>>
+    class sealable_map
+    {
+    public:
+        bool sealed() const noexcept { return _sealed; }
+        std::size_t size() const noexcept { return _sealed ? _values.size() : _map.size(); }
+
+        const V *find(const K &key) const noexcept
+        {
+            if (_sealed)
+            {
+                for (auto position = Hash{}(key) & _mask;; position = (position + 1) & _mask)
+                {
+                    const auto &slot = _slots[position];
+                    if (slot.index == empty)
+                        return nullptr;
+
+                    if (Equal{}(slot.key, key))
+                        return &_values[slot.index];
+                }
+            }
+
+            if (auto where = _map.find(key); where != _map.end())
+                return &where->second;
+
+            return nullptr;
+        }
+
+        V *find(const K &key) noexcept
+        {
+            return const_cast<V *>(std::as_const(*this).find(key));
+        }
+
+        bool contains(const K &key) const noexcept
+        {
+            return find(key) != nullptr;
+        }
+
+        // Must not be called once sealed, owners reject registrations before reaching here
+        V &emplace(const K &key, V value)
+        {
+            return _map.emplace(key, std::move(value)).first->second;
+        }
+
+        std::vector<const V *> values() const noexcept
+        {
+            std::vector<const V *> values;
+            values.reserve(size());
+
+            if (_sealed)
+                std::ranges::transform(_values, std::back_inserter(values), [](const auto &value) { return &value; });
+            else
+                std::ranges::transform(_map, std::back_inserter(values), [](const auto &pair) { return &pair.second; });
+
+            return values;
+        }
+
+        template <typename F>
+        void forEach(F fn)
+        {
+            if (_sealed)
+                std::ranges::for_each(_values, fn);
+            else
+                std::ranges::for_each(_map, [&fn](auto &pair) { fn(pair.second); });
+        }
+
+        template <typename F>
+        void forEach(F fn) const
+        {
+            if (_sealed)
+                std::ranges::for_each(_values, fn);
+            else
+                std::ranges::for_each(_map, [&fn](const auto &pair) { fn(pair.second); });
+        }
+
+        // Heap bytes of the table and the values stored in it, without what the values own themselves.
+        // Nodes of the unsealed map are assumed to hold a next pointer and the cached hash.
+        std::size_t heapSize() const noexcept
+        {
+            if (_sealed)
+                return _slots.capacity() * sizeof(slot) + _values.capacity() * sizeof(V);
+
+            constexpr auto node = sizeof(void *) + sizeof(std::pair<const K, V>) + sizeof(std::size_t);
+            return _map.empty() ? 0 : _map.bucket_count() * sizeof(void *) + _map.size() * node;
+        }
+
+        void seal()
+        {
+            if (_sealed)
+                return;
+
+            std::size_t capacity = 1;
+            while (capacity < 2 * _map.size())
+                capacity <<= 1;
+
+            _mask = capacity - 1;
+            _slots.assign(capacity, slot{K(), empty});
+            _values.reserve(_map.size());
+
+            for (auto &[key, value] : _map)
+            {
+                auto position = Hash{}(key) & _mask;
+                while (_slots[position].index != empty)
+                    position = (position + 1) & _mask;
+
+                _slots[position] = slot{key, static_cast<std::uint32_t>(_values.size())};
+                _values.push_back(std::move(value));
+            }
+
+            std::unordered_map<K, V, Hash, Equal>().swap(_map);
+            _sealed = true;
+        }
+
+    private:
+        static constexpr auto empty = std::numeric_limits<std::uint32_t>::max();
+
+        struct slot
+        {
+            K key;
+            std::uint32_t index;
+        };
+
+        bool _sealed = false;
+        std::unordered_map<K, V, Hash, Equal> _map;
+        std::vector<slot> _slots;
+        std::vector<V> _values;
+        std::size_t _mask = 0;
+    };
+}
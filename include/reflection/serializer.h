@@ -0,0 +1,128 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <optional>
+
+#include "reflection/metaobject.h"
+#include "reflection/exceptions.h"
+
+namespace lh::reflection
+{
+    // Binary encoding of the properties of a MetaObject. The constructor compiles a plan of all properties
+    // ordered by name together with their wire encoders, encoding an instance is then one pass over the
+    // plan. Arithmetic properties are written little-endian at their natural width, strings as a 32-bit
+    // length followed by their bytes; properties of other types are rejected. On little-endian hosts,
+    // fixed size instances encoded one at a time copy properties backed by data members that are
+    // adjacent both on the wire and in the instance as one block.
+    class Serializer final
+    {
+    public:
+        explicit Serializer(const MetaObject &metaObject);
+
+        // Encoded size of every instance, or 0 if it depends on the instance because of strings
+        std::size_t fixedSize() const noexcept { return _fixedSize; }
+        std::size_t fields() const noexcept { return _fields.size(); }
+
+        // Returns the number of bytes written, throws if out is too small
+        template <typename C>
+        std::size_t encode(const C *instance, std::span<std::byte> out) const
+        {
+            if (auto written = tryEncode(static_cast<const void *>(instance), out))
+                return *written;
+
+            throw serialization_failed("buffer of " + std::to_string(out.size()) + " bytes is too small for " + _name);
+        }
+
+        // Returns the number of bytes read, throws if in is truncated
+        template <typename C>
+        std::size_t decode(C *instance, std::span<const std::byte> in) const
+        {
+            return decodeInstance(static_cast<void *>(instance), in);
+        }
+
+        // Encodes instances back to back into buffer, handing every filled part of it to sink before
+        // reusing it. Returns the total number of bytes encoded.
+        template <typename C, typename Sink>
+        std::size_t encode(std::span<const C> instances, std::span<std::byte> buffer, Sink sink) const
+        {
+            // Fixed size records are encoded one property at a time over as many instances as fit
+            if (_fixedSize && _columnar && buffer.size() >= _fixedSize)
+            {
+                const auto batch = buffer.size() / _fixedSize;
+
+                for (std::size_t first = 0; first < instances.size(); first += batch)
+                {
+                    const auto count = std::min(batch, instances.size() - first);
+                    encodeColumns(instances.data() + first, sizeof(C), buffer.data(), count);
+                    sink(std::span<const std::byte>(buffer.first(count * _fixedSize)));
+                }
+
+                return instances.size() * _fixedSize;
+            }
+
+            std::size_t total = 0;
+            std::size_t used = 0;
+
+            for (const auto &instance : instances)
+            {
+                auto written = tryEncode(static_cast<const void *>(&instance), buffer.subspan(used));
+                if (!written && used)
+                {
+                    sink(std::span<const std::byte>(buffer.first(used)));
+                    used = 0;
+                    written = tryEncode(static_cast<const void *>(&instance), buffer);
+                }
+
+                if (!written)
+                    throw serialization_failed("buffer of " + std::to_string(buffer.size()) + " bytes is too small for one " + _name);
+
+                used += *written;
+                total += *written;
+            }
+
+            if (used)
+                sink(std::span<const std::byte>(buffer.first(used)));
+
+            return total;
+        }
+
+    private:
+        struct Field
+        {
+            using encode_t = std::byte *(*)(const Property &property, const void *instance, std::byte *out, std::byte *end);
+            using decode_t = const std::byte *(*)(const Property &property, void *instance, const std::byte *in, const std::byte *end);
+            using column_t = void (*)(const Property &property, const void *instances, std::size_t stride, std::byte *out, std::size_t recordSize, std::size_t count);
+
+            const Property *property;
+            std::size_t size;
+            std::size_t offset;
+            encode_t encode;
+            decode_t decode;
+            column_t column;
+
+            // Run of data members copied as size bytes from source within the instance instead
+            bool copy = false;
+            std::size_t source = 0;
+        };
+
+        // Gathered values are laid out natively, which is the wire layout on little-endian hosts only
+        template <typename T>
+        static void encodeColumn(const Property &property, const void *instances, std::size_t stride, std::byte *out, std::size_t recordSize, std::size_t count)
+        {
+            property.gatherColumn<T>(instances, stride, false, out, recordSize, count);
+        }
+
+        std::optional<std::size_t> tryEncode(const void *instance, std::span<std::byte> out) const;
+        void encodeColumns(const void *instances, std::size_t stride, std::byte *out, std::size_t count) const;
+        std::size_t decodeInstance(void *instance, std::span<const std::byte> in) const;
+
+        std::string _name;
+        std::vector<Field> _fields;
+        std::vector<Field> _blocks;
+        std::size_t _fixedSize = 0;
+        bool _columnar = false;
+    };
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <span>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <string_view>
+
+#include "reflection/metaobject.h"
+#include "reflection/exceptions.h"
+
+namespace lh::reflection
+{
+    // Read-only view of a schema image written by Library::snapshot. The image is position independent:
+    // records refer to each other and to a string pool by offsets from the start of the image, so it can
+    // be mapped straight from a file and queried in place. Types are found through a perfect hash stored
+    // in the image, members by binary search over their names. Type fingerprints are FNV-1a hashes of the
+    // implementation's type names, so they only agree between processes built with the same compiler.
+    class SchemaSnapshot final
+    {
+    public:
+        static constexpr std::uint32_t version = 1;
+
+        /* Image Records */
+
+        struct String
+        {
+            std::uint32_t offset;
+            std::uint32_t size;
+        };
+
+        struct Range
+        {
+            std::uint32_t offset;
+            std::uint32_t count;
+        };
+
+        struct TypeReference
+        {
+            std::uint64_t fingerprint;
+            String name;
+        };
+
+        struct ConstructorRecord
+        {
+            std::uint64_t signature;
+            Range arguments;
+        };
+
+        struct OverloadRecord
+        {
+            std::uint64_t signature;
+            TypeReference returnType;
+            Range arguments;
+            std::uint32_t qualifier;
+            std::uint32_t reserved;
+        };
+
+        struct MethodRecord
+        {
+            String name;
+            Range overloads;
+        };
+
+        struct PropertyRecord
+        {
+            String name;
+            TypeReference type;
+        };
+
+        struct EventRecord
+        {
+            std::uint64_t signature;
+            String name;
+            Range arguments;
+            std::uint32_t ordinal;
+            std::uint32_t reserved;
+        };
+
+        struct TypeRecord
+        {
+            std::uint64_t nameHash;
+            std::uint64_t fingerprint;
+            String name;
+            Range bases;
+            Range constructors;
+            Range methods;
+            Range properties;
+            Range events;
+        };
+
+        // Borrows the image, which has to be 8-byte aligned. Only the header is checked, verify()
+        // checks the content against its hash.
+        explicit SchemaSnapshot(std::span<const std::byte> image);
+
+        // Maps the file read-only, the mapping lives as long as any copy of the snapshot
+        static SchemaSnapshot map(const std::string &path);
+
+        std::span<const std::byte> image() const noexcept { return _image; }
+        std::uint64_t contentHash() const noexcept;
+        bool verify() const noexcept;
+
+        /* Lookup */
+
+        std::span<const TypeRecord> types() const noexcept { return range<TypeRecord>(_types); }
+        const TypeRecord *find(std::string_view name) const noexcept;
+
+        const MethodRecord *method(const TypeRecord &type, std::string_view name) const noexcept;
+        const PropertyRecord *property(const TypeRecord &type, std::string_view name) const noexcept;
+        const EventRecord *event(const TypeRecord &type, std::string_view name) const noexcept;
+
+        std::string_view string(String value) const noexcept
+        {
+            return {reinterpret_cast<const char *>(_image.data()) + _strings + value.offset, value.size};
+        }
+
+        std::span<const TypeReference> bases(const TypeRecord &type) const noexcept { return range<TypeReference>(type.bases); }
+        std::span<const ConstructorRecord> constructors(const TypeRecord &type) const noexcept { return range<ConstructorRecord>(type.constructors); }
+        std::span<const MethodRecord> methods(const TypeRecord &type) const noexcept { return range<MethodRecord>(type.methods); }
+        std::span<const PropertyRecord> properties(const TypeRecord &type) const noexcept { return range<PropertyRecord>(type.properties); }
+        std::span<const EventRecord> events(const TypeRecord &type) const noexcept { return range<EventRecord>(type.events); }
+
+        std::span<const OverloadRecord> overloads(const MethodRecord &method) const noexcept { return range<OverloadRecord>(method.overloads); }
+        std::span<const TypeReference> arguments(const ConstructorRecord &constructor) const noexcept { return range<TypeReference>(constructor.arguments); }
+        std::span<const TypeReference> arguments(const OverloadRecord &overload) const noexcept { return range<TypeReference>(overload.arguments); }
+        std::span<const TypeReference> arguments(const EventRecord &event) const noexcept { return range<TypeReference>(event.arguments); }
+
+        /* Compatibility */
+
+        // True if the snapshot has a type of the same name and fingerprint, and every base, constructor,
+        // overload, property and event recorded for it exists on metaObject with the same types. Members
+        // added since the snapshot was taken do not break compatibility.
+        bool compatible(const MetaObject &metaObject) const noexcept;
+
+        static std::uint64_t fingerprint(std::type_index type) noexcept { return utility::fnv1a(type.name()); }
+
+    private:
+        friend class Library;
+
+        struct Header;
+
+        static std::vector<std::byte> build(std::vector<const MetaObject *> metaObjects);
+
+        // Members are sorted by name
+        template <typename T>
+        const T *named(std::span<const T> records, std::string_view name) const noexcept
+        {
+            auto where = std::ranges::lower_bound(records, name, {}, [this](const T &record) { return string(record.name); });
+            return where != records.end() && string(where->name) == name ? &*where : nullptr;
+        }
+
+        template <typename T>
+        std::span<const T> range(Range value) const noexcept
+        {
+            return {reinterpret_cast<const T *>(_image.data() + value.offset), value.count};
+        }
+
+        const Header &header() const noexcept { return *reinterpret_cast<const Header *>(_image.data()); }
+
+        std::span<const std::byte> _image;
+        std::shared_ptr<const void> _mapping;
+
+        Range _types{};
+        std::span<const std::uint32_t> _slots;
+        std::span<const std::uint64_t> _displacements;
+        std::uint64_t _mask = 0;
+        std::uint32_t _strings = 0;
+    };
+}
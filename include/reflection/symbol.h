@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <functional>
+
+namespace lh::reflection
+{
+    // Interned name. Every distinct string is stored once in a process-wide table, so symbols compare
+    // by identity and carry the hash of their name, which makes them cheap keys for name-keyed maps.
+    class Symbol final
+    {
+    public:
+        struct Entry
+        {
+            std::string name;
+            std::size_t hash;
+            std::uint32_t id;
+        };
+
+        constexpr Symbol() noexcept = default;
+
+        // Returns the symbol for name, adding it to the table if necessary
+        static Symbol intern(std::string_view name);
+
+        // Returns the symbol for name, or an empty symbol if name has never been interned. Does not lock.
+        static Symbol find(std::string_view name) noexcept;
+
+        std::uint32_t id() const noexcept { return _entry ? _entry->id : 0; }
+        std::size_t hash() const noexcept { return _entry ? _entry->hash : 0; }
+        std::string_view name() const noexcept { return _entry ? std::string_view(_entry->name) : std::string_view(); }
+
+        explicit operator bool() const noexcept { return _entry != nullptr; }
+        bool operator==(const Symbol &other) const noexcept { return _entry == other._entry; }
+
+    private:
+        explicit Symbol(const Entry *entry) noexcept :
+            _entry(entry)
+        {
+        }
+
+        const Entry *_entry = nullptr;
+    };
+}
+
+namespace std
+{
+    template <>
+    struct hash<lh::reflection::Symbol>
+    {
+        std::size_t operator()(const lh::reflection::Symbol &s) const noexcept
+        {
+            return s.hash();
+        }
+    };
+}
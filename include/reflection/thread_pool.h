@@ -0,0 +1,80 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <exception>
+#include <type_traits>
+
+#include "reflection/utility.h"
+
+namespace lh::reflection
+{
+    // Worker threads for data-parallel loops. A loop is cut into chunks of grain indices, every thread
+    // starts on an equal share of them and threads that run out steal half of the remaining chunks of
+    // another, so uneven work still balances. The calling thread takes part, a pool without workers runs
+    // loops inline.
+    class ThreadPool final : private utility::non_copyable
+    {
+    public:
+        explicit ThreadPool(std::size_t workers = std::max(std::thread::hardware_concurrency(), 1u) - 1);
+        ThreadPool(ThreadPool &&) = delete;
+        ~ThreadPool();
+
+        // Process-wide pool with one thread per core, counting the caller
+        static ThreadPool &shared();
+
+        std::size_t workers() const noexcept { return _workers.size(); }
+
+        // Calls fn(begin, end) for ranges of at most grain indices that together cover [0, count) and
+        // returns once all have run. The first exception thrown is rethrown here, chunks that had not
+        // started by then are skipped. Loops started while the pool is busy, including nested ones, run
+        // inline on the calling thread.
+        template <typename F>
+        void parallelFor(std::size_t count, std::size_t grain, F &&fn)
+        {
+            using function_t = std::remove_reference_t<F>;
+
+            run(count, grain, [](const void *context, std::size_t begin, std::size_t end) {
+                (*static_cast<function_t *>(const_cast<void *>(context)))(begin, end);
+            }, &fn);
+        }
+
+    private:
+        using task_t = void (*)(const void *context, std::size_t begin, std::size_t end);
+
+        // Remaining chunks [begin, end) of one thread, packed so that taking from either end is one CAS
+        struct alignas(64) Range
+        {
+            std::atomic<std::uint64_t> bounds = 0;
+        };
+
+        void run(std::size_t count, std::size_t grain, task_t task, const void *context);
+        void work(std::size_t index);
+        void participate(std::size_t index) noexcept;
+        bool steal(std::size_t thief) noexcept;
+        void execute(std::uint64_t chunk) noexcept;
+
+        std::vector<std::thread> _workers;
+        std::unique_ptr<Range[]> _ranges;
+
+        std::mutex _submit;
+        std::atomic<std::uint32_t> _generation = 0;
+        std::atomic<std::size_t> _active = 0;
+        std::atomic<bool> _stopping = false;
+
+        task_t _task = nullptr;
+        const void *_context = nullptr;
+        std::size_t _count = 0;
+        std::size_t _grain = 1;
+
+        std::mutex _errorMutex;
+        std::exception_ptr _error;
+        std::atomic<bool> _failed = false;
+    };
+}
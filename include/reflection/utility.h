@@ -1,12 +1,22 @@
 #pragma once
 
+#include <span>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <vector>
 #include <iterator>
 #include <ranges>
 #include <algorithm>
 #include <typeindex>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#define REFLECTION_PRETTY_FUNCTION __FUNCSIG__
+#else
+#define REFLECTION_PRETTY_FUNCTION __PRETTY_FUNCTION__
+#endif
 
 namespace lh::reflection::utility
 {
@@ -21,6 +31,41 @@ namespace lh::reflection::utility
         non_copyable& operator= (non_copyable&&) = default;
     };
 
+    /* Function Traits */
+
+    template <typename F>
+    struct function_traits : function_traits<decltype(&F::operator())>
+    {
+    };
+
+    template <typename R, typename... Ts>
+    struct function_traits<R(Ts...)>
+    {
+        using return_type = R;
+        using signature = R(Ts...);
+    };
+
+    template <typename R, typename... Ts>
+    struct function_traits<R (*)(Ts...)> : function_traits<R(Ts...)>
+    {
+    };
+
+    template <typename R, typename F, typename... Ts>
+    struct function_traits<R (F::*)(Ts...)> : function_traits<R(Ts...)>
+    {
+    };
+
+    template <typename R, typename F, typename... Ts>
+    struct function_traits<R (F::*)(Ts...) const> : function_traits<R(Ts...)>
+    {
+    };
+
+    template <typename F>
+    using signature_of = std::type_identity<typename function_traits<F>::signature>;
+
+    template <typename F>
+    concept function_object = std::is_class_v<F> && requires { &F::operator(); };
+
     /* Algorithms */
 
     template <std::input_iterator iterator_t>
@@ -54,17 +99,102 @@ namespace lh::reflection::utility
 
     std::string signatureString(const std::vector<std::type_index> &arguments) noexcept;
 
+    // Name of T with its cv- and reference qualifiers, which typeid drops
+    template <class T>
+    std::string typeName() noexcept
+    {
+        using value_t = std::remove_reference_t<T>;
+
+        std::string name = typeid(T).name();
+        if constexpr (std::is_const_v<value_t>)
+            name += " const";
+        if constexpr (std::is_volatile_v<value_t>)
+            name += " volatile";
+        if constexpr (std::is_lvalue_reference_v<T>)
+            name += " &";
+        else if constexpr (std::is_rvalue_reference_v<T>)
+            name += " &&";
+
+        return name;
+    }
+
     template <class... Ts>
     std::string signatureString() noexcept
     {
-        return join(std::vector<std::string>{std::string(typeid(Ts).name())...}, ", ");
+        return join(std::vector<std::string>{typeName<Ts>()...}, ", ");
+    }
+
+    /* Type Identifiers */
+
+    constexpr std::uint64_t fnv1a(std::string_view value) noexcept
+    {
+        std::uint64_t hash = 0xcbf29ce484222325;
+        for (const auto c : value)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 0x100000001b3;
+        }
+
+        return hash;
     }
 
-    size_t signatureHash(const std::vector<std::type_index> &arguments) noexcept;
+    constexpr std::size_t hashCombine(std::size_t hash, std::size_t value) noexcept
+    {
+        return hash ^ (value + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+    }
+
+    // Derived from the spelling of T in the compiler's function signature, so unlike typeid(T).hash_code()
+    // it is a compile-time constant, keeps cv- and reference qualifiers, and agrees across translation
+    // units and shared libraries. Types with internal linkage are not distinguished across translation units.
+    template <class T>
+    consteval std::size_t typeId() noexcept
+    {
+        return static_cast<std::size_t>(fnv1a(REFLECTION_PRETTY_FUNCTION));
+    }
 
     template <class... Ts>
-    size_t signatureHash() noexcept
+    constexpr std::size_t signatureHash() noexcept
+    {
+        std::size_t hash = 0;
+        ((hash = hashCombine(hash, typeId<Ts>())), ...);
+        return hash;
+    }
+
+    /* Views */
+
+    // Owning type a view type refers into, see Property::get
+    template <typename T>
+    struct view_source
+    {
+    };
+
+    template <typename Char, typename Traits>
+    struct view_source<std::basic_string_view<Char, Traits>>
+    {
+        using type = std::basic_string<Char, Traits>;
+    };
+
+    template <typename T>
+    struct view_source<std::span<const T>>
+    {
+        using type = std::vector<T>;
+    };
+
+    template <typename T>
+    using view_source_t = typename view_source<T>::type;
+
+    template <typename T>
+    constexpr bool is_view_v = requires { typename view_source_t<T>; };
+
+    /* Members */
+
+    // Offset of a data member from the start of C. The member is addressed on uninitialized storage,
+    // which is fine since a pointer to member never refers into a virtual base of C.
+    template <typename T, typename C>
+    std::size_t memberOffset(T C::*member) noexcept
     {
-        return signatureHash(signature<Ts...>());
+        alignas(C) unsigned char storage[sizeof(C)];
+        const auto object = reinterpret_cast<const C *>(storage);
+        return static_cast<std::size_t>(reinterpret_cast<const unsigned char *>(&(object->*member)) - storage);
     }
 }
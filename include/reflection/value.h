@@ -0,0 +1,284 @@
+#pragma once
+
+#include <new>
+#include <span>
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <utility>
+#include <typeinfo>
+#include <typeindex>
+#include <type_traits>
+
+#include "reflection/utility.h"
+#include "reflection/arena.h"
+#include "reflection/exceptions.h"
+
+namespace lh::reflection
+{
+    // Type-erased value for calls whose argument types are only known at runtime. Scalars and objects up
+    // to the size of a std::string are stored inline, so numbers and short strings never touch the heap;
+    // larger objects are allocated. Values always hold the decayed type of what they were created from.
+    class Value final
+    {
+    public:
+        static constexpr std::size_t capacity = 4 * sizeof(void *);
+
+        template <typename T>
+        static constexpr bool is_inline = sizeof(T) <= capacity && alignof(T) <= alignof(void *) && std::is_nothrow_move_constructible_v<T>;
+
+        Value() noexcept = default;
+
+        template <typename T>
+            requires(!std::is_same_v<std::remove_cvref_t<T>, Value>)
+        Value(T &&value)
+        {
+            emplace<std::decay_t<T>>(std::forward<T>(value));
+        }
+
+        Value(const char *value) :
+            Value(std::string(value))
+        {
+        }
+
+        Value(const Value &other)
+        {
+            if (other._operations)
+            {
+                other._operations->copy(_storage, other._storage);
+                _operations = other._operations;
+            }
+        }
+
+        Value(Value &&other) noexcept
+        {
+            take(other);
+        }
+
+        Value &operator=(const Value &other)
+        {
+            if (this != &other)
+            {
+                Value copy(other);
+                reset();
+                take(copy);
+            }
+
+            return *this;
+        }
+
+        Value &operator=(Value &&other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                take(other);
+            }
+
+            return *this;
+        }
+
+        ~Value()
+        {
+            reset();
+        }
+
+        template <typename T, typename... Ts>
+        T &emplace(Ts &&...args)
+        {
+            static_assert(std::is_same_v<T, std::decay_t<T>>, "values hold decayed types only");
+
+            reset();
+
+            T *object;
+            if constexpr (is_inline<T>)
+                object = ::new (static_cast<void *>(_storage)) T(std::forward<Ts>(args)...);
+            else
+                ::new (static_cast<void *>(_storage)) T *(object = new T(std::forward<Ts>(args)...));
+
+            _operations = &operations<T>;
+            return *object;
+        }
+
+        void reset() noexcept
+        {
+            if (_operations && _operations->destroy)
+                _operations->destroy(_storage);
+
+            _operations = nullptr;
+        }
+
+        bool empty() const noexcept { return _operations == nullptr; }
+        explicit operator bool() const noexcept { return _operations != nullptr; }
+
+        // Same identifier as utility::typeId of the held type, or of void if empty
+        std::size_t typeId() const noexcept { return _operations ? _operations->typeId : utility::typeId<void>(); }
+        std::type_index type() const noexcept { return _operations ? std::type_index(*_operations->type) : std::type_index(typeid(void)); }
+
+        // Whether the held object lives in the value itself rather than on the heap
+        bool isInline() const noexcept { return _operations && _operations->inlined; }
+
+        template <typename T>
+        bool holds() const noexcept
+        {
+            return typeId() == utility::typeId<T>();
+        }
+
+        template <typename T>
+        T *tryGet() noexcept
+        {
+            return holds<T>() ? address<T>() : nullptr;
+        }
+
+        template <typename T>
+        const T *tryGet() const noexcept
+        {
+            return holds<T>() ? address<T>() : nullptr;
+        }
+
+        template <typename T>
+        T &get()
+        {
+            check<T>();
+            return *address<T>();
+        }
+
+        template <typename T>
+        const T &get() const
+        {
+            check<T>();
+            return *address<T>();
+        }
+
+        // Hands the held object to a parameter of type T: references bind to it, by-value and rvalue
+        // reference parameters move from it
+        template <typename T>
+        T pass()
+        {
+            using U = std::remove_cvref_t<T>;
+
+            if constexpr (std::is_lvalue_reference_v<T>)
+                return get<U>();
+            else
+                return std::move(get<U>());
+        }
+
+        // Runtime counterpart of utility::signatureHash over the held types, so a call with values of
+        // types Ts... finds the overload registered for Ts...
+        static std::size_t signatureHash(std::span<const Value> values) noexcept
+        {
+            std::size_t hash = 0;
+            for (const auto &value : values)
+                hash = utility::hashCombine(hash, value.typeId());
+
+            return hash;
+        }
+
+        static std::string signatureString(std::span<const Value> values);
+
+    private:
+        // Copies or moves into uninitialized storage; a null move is a plain memcpy, a null destroy a no-op
+        struct Operations
+        {
+            std::size_t typeId;
+            const std::type_info *type;
+            bool inlined;
+            void (*copy)(void *target, const void *source);
+            void (*move)(void *target, void *source) noexcept;
+            void (*destroy)(void *storage) noexcept;
+        };
+
+        template <typename T>
+        static void copy(void *target, const void *source)
+        {
+            if constexpr (!std::is_copy_constructible_v<T>)
+                throw invalid_value_type("type " + std::string(typeid(T).name()) + " is not copyable");
+            else if constexpr (is_inline<T>)
+                ::new (target) T(*std::launder(static_cast<const T *>(source)));
+            else
+                ::new (target) T *(new T(**static_cast<T *const *>(source)));
+        }
+
+        template <typename T>
+        static void move(void *target, void *source) noexcept
+        {
+            ::new (target) T(std::move(*std::launder(static_cast<T *>(source))));
+            std::launder(static_cast<T *>(source))->~T();
+        }
+
+        template <typename T>
+        static void destroy(void *storage) noexcept
+        {
+            if constexpr (is_inline<T>)
+                std::launder(static_cast<T *>(storage))->~T();
+            else
+                delete *static_cast<T **>(storage);
+        }
+
+        template <typename T>
+        static constexpr Operations operations = {
+            utility::typeId<T>(),
+            &typeid(T),
+            is_inline<T>,
+            &copy<T>,
+            is_inline<T> && !std::is_trivially_copyable_v<T> ? &move<T> : nullptr,
+            is_inline<T> && std::is_trivially_destructible_v<T> ? nullptr : &destroy<T>};
+
+        template <typename T>
+        T *address() const noexcept
+        {
+            if constexpr (is_inline<T>)
+                return std::launder(reinterpret_cast<T *>(const_cast<unsigned char *>(_storage)));
+            else
+                return *reinterpret_cast<T *const *>(_storage);
+        }
+
+        template <typename T>
+        void check() const
+        {
+            if (!holds<T>())
+                throw invalid_value_type("type " + std::string(typeid(T).name()) + " is incompatible with held type " + std::string(type().name()));
+        }
+
+        void take(Value &other) noexcept
+        {
+            _operations = std::exchange(other._operations, nullptr);
+
+            if (!_operations)
+                return;
+
+            if (_operations->move)
+                _operations->move(_storage, other._storage);
+            else
+                std::memcpy(_storage, other._storage, capacity);
+        }
+
+        alignas(void *) unsigned char _storage[capacity];
+        const Operations *_operations = nullptr;
+    };
+
+    // Arguments of one dynamic call, placed on a thread-local stack so that building them does not
+    // allocate. Frames of a thread must end in reverse order of creation, which scoping them ensures.
+    class ArgumentFrame final
+    {
+    public:
+        explicit ArgumentFrame(std::size_t size);
+        ~ArgumentFrame();
+
+        ArgumentFrame(const ArgumentFrame &) = delete;
+        ArgumentFrame &operator=(const ArgumentFrame &) = delete;
+
+        Value &operator[](std::size_t index) noexcept { return _values[index]; }
+        const Value &operator[](std::size_t index) const noexcept { return _values[index]; }
+
+        std::size_t size() const noexcept { return _size; }
+        std::span<Value> values() noexcept { return {_values, _size}; }
+
+        operator std::span<Value>() noexcept { return values(); }
+
+    private:
+        utility::arena::marker _marker;
+        Value *_values;
+        std::size_t _size;
+    };
+}
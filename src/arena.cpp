@@ -0,0 +1,66 @@
+#include "reflection/arena.h"
+
+#include <utility>
+#include <algorithm>
+
+namespace lh::reflection::utility
+{
+    arena::~arena()
+    {
+        finalize();
+
+        while (_block)
+        {
+            auto previous = _block->previous;
+            _upstream->deallocate(_block, _block->size, alignof(std::max_align_t));
+            _block = previous;
+        }
+    }
+
+    void arena::adopt(void *object, destroy_t destroy)
+    {
+        auto finalizer = static_cast<Finalizer *>(allocate(sizeof(Finalizer), alignof(Finalizer)));
+        *finalizer = Finalizer{_finalizers, object, destroy};
+        _finalizers = finalizer;
+    }
+
+    void arena::release() noexcept
+    {
+        finalize();
+
+        if (!_block)
+            return;
+
+        // Blocks double in size, so the newest one is kept as the largest
+        while (auto previous = _block->previous)
+        {
+            _block->previous = previous->previous;
+            _upstream->deallocate(previous, previous->size, alignof(std::max_align_t));
+        }
+
+        _current = reinterpret_cast<std::byte *>(_block + 1);
+        _retired = 0;
+    }
+
+    std::size_t arena::allocated() const noexcept
+    {
+        return _block ? _retired + static_cast<std::size_t>(_current - reinterpret_cast<std::byte *>(_block + 1)) : 0;
+    }
+
+    void *arena::grow(std::size_t bytes, std::size_t alignment)
+    {
+        if (_block)
+            _retired += static_cast<std::size_t>(_current - reinterpret_cast<std::byte *>(_block + 1));
+
+        const auto size = std::max({_blockSize, _block ? 2 * _block->size : 0, sizeof(Block) + bytes + alignment});
+
+        auto block = static_cast<Block *>(_upstream->allocate(size, alignof(std::max_align_t)));
+        *block = Block{_block, size};
+
+        _block = block;
+        _current = reinterpret_cast<std::byte *>(block + 1);
+        _end = reinterpret_cast<std::byte *>(block) + size;
+
+        return allocate(bytes, alignment);
+    }
+}
@@ -0,0 +1,130 @@
+#include "reflection/event_bus.h"
+
+#include <latch>
+
+namespace lh::reflection
+{
+    EventBus::EventBus(std::size_t workers, std::size_t capacity, Overflow overflow) :
+        _overflow(overflow)
+    {
+        _workers.reserve(std::max<std::size_t>(workers, 1));
+        for (std::size_t i = 0; i < std::max<std::size_t>(workers, 1); ++i)
+            _workers.push_back(std::make_unique<Worker>(capacity));
+
+        for (auto &worker : _workers)
+            worker->thread = std::thread(&EventBus::run, this, std::ref(*worker));
+    }
+
+    EventBus::~EventBus()
+    {
+        _stopping = true;
+
+        for (auto &worker : _workers)
+        {
+            worker->signal.fetch_add(1, std::memory_order_release);
+            worker->signal.notify_one();
+        }
+
+        for (auto &worker : _workers)
+            worker->thread.join();
+    }
+
+    void EventBus::flush()
+    {
+        std::latch done(static_cast<std::ptrdiff_t>(_workers.size()));
+
+        for (auto &worker : _workers)
+        {
+            Delivery barrier([&done]() { done.count_down(); }, true);
+            while (!worker->queue.try_push(barrier))
+                std::this_thread::yield();
+
+            worker->signal.fetch_add(1, std::memory_order_release);
+            worker->signal.notify_one();
+        }
+
+        done.wait();
+    }
+
+    bool EventBus::push(Worker &worker, Delivery &delivery)
+    {
+        while (!worker.queue.try_push(delivery))
+        {
+            switch (_overflow)
+            {
+            case Overflow::Block:
+                std::this_thread::yield();
+                break;
+
+            case Overflow::DropNewest:
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+
+            case Overflow::DropOldest:
+                if (auto oldest = worker.queue.try_pop())
+                {
+                    // A barrier must not be lost, it goes back to the end of the queue, which only delays it
+                    if (oldest->barrier())
+                        push(worker, *oldest);
+                    else
+                        _dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+                break;
+            }
+        }
+
+        worker.signal.fetch_add(1, std::memory_order_release);
+        worker.signal.notify_one();
+        return true;
+    }
+
+    void EventBus::run(Worker &worker)
+    {
+        // Polls for a while before going to sleep, waking a worker costs far more than a delivery
+        constexpr int spins = 64;
+
+        for (int idle = 0;;)
+        {
+            if (auto delivery = worker.queue.try_pop())
+            {
+                deliver(*delivery);
+                idle = 0;
+                continue;
+            }
+
+            if (++idle < spins)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            const auto seen = worker.signal.load(std::memory_order_acquire);
+
+            if (auto delivery = worker.queue.try_pop())
+            {
+                deliver(*delivery);
+                idle = 0;
+                continue;
+            }
+
+            if (_stopping)
+                return;
+
+            worker.signal.wait(seen, std::memory_order_acquire);
+        }
+    }
+
+    // An exception must not leave the worker thread, which would terminate, nor stop the deliveries and
+    // barriers queued behind it
+    void EventBus::deliver(Delivery &delivery) noexcept
+    {
+        try
+        {
+            delivery.run();
+        }
+        catch (...)
+        {
+            _failed.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,542 @@
+#include "reflection/json.h"
+
+#include <bit>
+#include <cmath>
+#include <charconv>
+#include <algorithm>
+#include <functional>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace lh::reflection
+{
+    namespace
+    {
+        constexpr std::size_t maximumDepth = 512;
+
+        bool isWhitespace(char c) noexcept
+        {
+            return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+        }
+
+        bool isSpecial(char c) noexcept
+        {
+            return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+        }
+
+        // First quote, backslash or control character in [position, end), or end
+        const char *scanString(const char *position, const char *end) noexcept
+        {
+#if defined(__SSE2__)
+            const auto quote = _mm_set1_epi8('"');
+            const auto backslash = _mm_set1_epi8('\\');
+            const auto control = _mm_set1_epi8(0x1f);
+
+            for (; end - position >= 16; position += 16)
+            {
+                const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(position));
+                const auto special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                                                  _mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk));
+
+                if (const auto bits = _mm_movemask_epi8(special))
+                    return position + std::countr_zero(static_cast<unsigned>(bits));
+            }
+#endif
+            while (position != end && !isSpecial(*position))
+                ++position;
+
+            return position;
+        }
+
+        // First character in [position, end) that is not whitespace, or end
+        const char *scanWhitespace(const char *position, const char *end) noexcept
+        {
+            // Compact JSON rarely has any, so check one character before going wide
+            if (position == end || !isWhitespace(*position))
+                return position;
+
+#if defined(__SSE2__)
+            for (; end - position >= 16; position += 16)
+            {
+                const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(position));
+                const auto whitespace = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))),
+                                                     _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))));
+
+                if (const auto bits = ~_mm_movemask_epi8(whitespace) & 0xffff)
+                    return position + std::countr_zero(static_cast<unsigned>(bits));
+            }
+#endif
+            while (position != end && isWhitespace(*position))
+                ++position;
+
+            return position;
+        }
+
+        void appendUtf8(std::string &out, std::uint32_t codepoint)
+        {
+            if (codepoint < 0x80)
+            {
+                out.push_back(static_cast<char>(codepoint));
+            }
+            else if (codepoint < 0x800)
+            {
+                out.push_back(static_cast<char>(0xc0 | (codepoint >> 6)));
+                out.push_back(static_cast<char>(0x80 | (codepoint & 0x3f)));
+            }
+            else if (codepoint < 0x10000)
+            {
+                out.push_back(static_cast<char>(0xe0 | (codepoint >> 12)));
+                out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3f)));
+                out.push_back(static_cast<char>(0x80 | (codepoint & 0x3f)));
+            }
+            else
+            {
+                out.push_back(static_cast<char>(0xf0 | (codepoint >> 18)));
+                out.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3f)));
+                out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3f)));
+                out.push_back(static_cast<char>(0x80 | (codepoint & 0x3f)));
+            }
+        }
+
+        void appendString(std::string &out, std::string_view value)
+        {
+            static constexpr char hex[] = "0123456789abcdef";
+
+            out.push_back('"');
+
+            auto position = value.data();
+            const auto end = value.data() + value.size();
+
+            while (position != end)
+            {
+                const auto special = scanString(position, end);
+                out.append(position, special);
+                if (special == end)
+                    break;
+
+                switch (const auto c = *special)
+                {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                case '\b': out += "\\b"; break;
+                case '\f': out += "\\f"; break;
+                default:
+                    out += "\\u00";
+                    out.push_back(hex[(c >> 4) & 0xf]);
+                    out.push_back(hex[c & 0xf]);
+                }
+
+                position = special + 1;
+            }
+
+            out.push_back('"');
+        }
+    }
+
+    class JsonCodec::Reader
+    {
+    public:
+        explicit Reader(std::string_view json) noexcept :
+            _begin(json.data()),
+            _position(json.data()),
+            _end(json.data() + json.size())
+        {
+        }
+
+        std::size_t consumed() const noexcept { return static_cast<std::size_t>(_position - _begin); }
+
+        [[noreturn]] void fail(std::string_view what) const
+        {
+            throw serialization_failed("invalid JSON at offset " + std::to_string(consumed()) + ": " + std::string(what));
+        }
+
+        char peek()
+        {
+            _position = scanWhitespace(_position, _end);
+            if (_position == _end)
+                fail("unexpected end of input");
+
+            return *_position;
+        }
+
+        bool consume(char c)
+        {
+            if (peek() != c)
+                return false;
+
+            ++_position;
+            return true;
+        }
+
+        void expect(char c)
+        {
+            if (!consume(c))
+                fail(std::string("expected '") + c + "'");
+        }
+
+        bool literal(std::string_view word)
+        {
+            if (static_cast<std::size_t>(_end - _position) < word.size() || std::string_view(_position, word.size()) != word)
+                return false;
+
+            _position += word.size();
+            return true;
+        }
+
+        bool null()
+        {
+            return peek() == 'n' && literal("null");
+        }
+
+        bool boolean()
+        {
+            peek();
+            if (literal("true"))
+                return true;
+
+            if (literal("false"))
+                return false;
+
+            fail("expected a boolean");
+        }
+
+        template <typename T>
+        T number()
+        {
+            peek();
+
+            T value;
+            const auto token = numberEnd();
+            const auto [end, error] = std::from_chars(_position, token, value);
+
+            if (error != std::errc() || end != token)
+                fail(std::is_integral_v<T> ? "expected an integer in range" : "expected a number");
+
+            _position = end;
+            return value;
+        }
+
+        // Returns a view of the input if the string has no escapes, otherwise unescapes into scratch
+        std::string_view string(std::string &scratch)
+        {
+            expect('"');
+
+            const auto start = _position;
+            auto special = scanString(_position, _end);
+            if (special != _end && *special == '"')
+            {
+                _position = special + 1;
+                return std::string_view(start, special);
+            }
+
+            scratch.clear();
+            for (;;)
+            {
+                special = scanString(_position, _end);
+                scratch.append(_position, special);
+                _position = special;
+
+                if (_position == _end)
+                    fail("unterminated string");
+
+                const auto c = *_position++;
+                if (c == '"')
+                    return scratch;
+
+                if (c != '\\')
+                    fail("control character in string");
+
+                if (_position == _end)
+                    fail("unterminated escape");
+
+                switch (*_position++)
+                {
+                case '"': scratch.push_back('"'); break;
+                case '\\': scratch.push_back('\\'); break;
+                case '/': scratch.push_back('/'); break;
+                case 'b': scratch.push_back('\b'); break;
+                case 'f': scratch.push_back('\f'); break;
+                case 'n': scratch.push_back('\n'); break;
+                case 'r': scratch.push_back('\r'); break;
+                case 't': scratch.push_back('\t'); break;
+                case 'u': appendUtf8(scratch, codepoint()); break;
+                default: fail("invalid escape");
+                }
+            }
+        }
+
+        void skipValue(std::size_t depth = 0)
+        {
+            if (depth > maximumDepth)
+                fail("nesting too deep");
+
+            std::string scratch;
+
+            switch (peek())
+            {
+            case '{':
+                ++_position;
+                if (consume('}'))
+                    return;
+
+                do
+                {
+                    string(scratch);
+                    expect(':');
+                    skipValue(depth + 1);
+                } while (consume(','));
+
+                expect('}');
+                return;
+
+            case '[':
+                ++_position;
+                if (consume(']'))
+                    return;
+
+                do
+                    skipValue(depth + 1);
+                while (consume(','));
+
+                expect(']');
+                return;
+
+            case '"':
+                string(scratch);
+                return;
+
+            case 't':
+            case 'f':
+                boolean();
+                return;
+
+            case 'n':
+                if (!literal("null"))
+                    fail("expected null");
+                return;
+
+            default:
+                // Only the shape of skipped numbers is checked, converting them is the expensive part
+                if (const auto token = numberEnd(); token != _position)
+                    _position = token;
+                else
+                    fail("unexpected character");
+            }
+        }
+
+    private:
+        const char *numberEnd() const noexcept
+        {
+            auto position = _position;
+            while (position != _end && ((*position >= '0' && *position <= '9') || *position == '-' || *position == '+' || *position == '.' || *position == 'e' || *position == 'E'))
+                ++position;
+
+            return position;
+        }
+
+        std::uint32_t hexQuad()
+        {
+            if (_end - _position < 4)
+                fail("truncated unicode escape");
+
+            std::uint32_t value = 0;
+            const auto [end, error] = std::from_chars(_position, _position + 4, value, 16);
+            if (error != std::errc() || end != _position + 4)
+                fail("invalid unicode escape");
+
+            _position += 4;
+            return value;
+        }
+
+        std::uint32_t codepoint()
+        {
+            const auto high = hexQuad();
+            if (high < 0xd800 || high > 0xdfff)
+                return high;
+
+            if (high > 0xdbff || !literal("\\u"))
+                fail("unpaired surrogate");
+
+            const auto low = hexQuad();
+            if (low < 0xdc00 || low > 0xdfff)
+                fail("unpaired surrogate");
+
+            return 0x10000 + ((high - 0xd800) << 10) + (low - 0xdc00);
+        }
+
+        const char *_begin;
+        const char *_position;
+        const char *_end;
+    };
+
+    namespace
+    {
+        template <typename T>
+        void readValue(const Property &property, void *instance, JsonCodec::Reader &reader)
+        {
+            if (reader.null())
+                return;
+
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                property.set<void, bool>(instance, reader.boolean());
+            }
+            else if constexpr (std::is_arithmetic_v<T>)
+            {
+                property.set<void, T>(instance, reader.template number<T>());
+            }
+            else
+            {
+                std::string scratch;
+                property.set<void, std::string>(instance, std::string(reader.string(scratch)));
+            }
+        }
+
+        template <typename T>
+        void writeValue(const Property &property, const void *instance, std::string &out)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                out += property.get<void, bool>(instance) ? "true" : "false";
+            }
+            else if constexpr (std::is_arithmetic_v<T>)
+            {
+                const auto value = property.get<void, T>(instance);
+
+                if constexpr (std::is_floating_point_v<T>)
+                {
+                    if (!std::isfinite(value))
+                    {
+                        out += "null";
+                        return;
+                    }
+                }
+
+                char buffer[32];
+                const auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+                out.append(buffer, end);
+            }
+            else if (property.byReference())
+            {
+                appendString(out, property.get<void, std::string_view>(instance));
+            }
+            else
+            {
+                appendString(out, property.get<void, std::string>(instance));
+            }
+        }
+    }
+
+    JsonCodec::JsonCodec(const MetaObject &metaObject) :
+        _name(metaObject.name())
+    {
+        auto properties = metaObject.properties();
+        std::ranges::sort(properties, [](const Property *a, const Property *b) { return a->name() < b->name(); });
+
+        _fields.reserve(properties.size());
+        for (const auto *property : properties)
+        {
+            auto supported = [&]<typename... Ts>(std::type_identity<Ts>...) {
+                return ((property->hash() == utility::typeId<Ts>() && (_fields.push_back(Field{property->name(), {}, property, &readValue<Ts>, &writeValue<Ts>}), true)) || ...);
+            };
+
+            if (!supported(std::type_identity<bool>(),
+                           std::type_identity<std::int8_t>(), std::type_identity<std::uint8_t>(),
+                           std::type_identity<std::int16_t>(), std::type_identity<std::uint16_t>(),
+                           std::type_identity<std::int32_t>(), std::type_identity<std::uint32_t>(),
+                           std::type_identity<std::int64_t>(), std::type_identity<std::uint64_t>(),
+                           std::type_identity<float>(), std::type_identity<double>(), std::type_identity<std::string>()))
+                throw serialization_failed("property " + property->name() + " of " + _name + " has unsupported type " + property->type().name());
+
+            appendString(_fields.back().prefix, _fields.back().name);
+            _fields.back().prefix.push_back(':');
+        }
+
+        std::vector<std::uint64_t> hashes;
+        std::ranges::transform(_fields, std::back_inserter(hashes), [](const Field &field) { return std::hash<std::string_view>{}(field.name); });
+
+        _index = utility::perfect_hash(hashes);
+        _slots.assign(_index.slots(), empty_slot);
+
+        for (std::size_t i = 0; i < _fields.size(); ++i)
+            _slots[_index.slot(hashes[i])] = static_cast<std::uint32_t>(i);
+    }
+
+    const JsonCodec::Field *JsonCodec::field(std::string_view key) const noexcept
+    {
+        if (_slots.empty())
+            return nullptr;
+
+        const auto slot = _slots[_index.slot(std::hash<std::string_view>{}(key))];
+        return slot != empty_slot && _fields[slot].name == key ? &_fields[slot] : nullptr;
+    }
+
+    std::size_t JsonCodec::readObject(void *instance, std::string_view json) const
+    {
+        Reader reader(json);
+        readObject(instance, reader);
+        return reader.consumed();
+    }
+
+    void JsonCodec::readObject(void *instance, Reader &reader) const
+    {
+        reader.expect('{');
+        if (reader.consume('}'))
+            return;
+
+        std::string scratch;
+        do
+        {
+            const auto key = reader.string(scratch);
+            const auto *found = field(key);
+
+            reader.expect(':');
+
+            if (found)
+                found->read(*found->property, instance, reader);
+            else
+                reader.skipValue();
+        } while (reader.consume(','));
+
+        reader.expect('}');
+    }
+
+    std::size_t JsonCodec::readElements(std::string_view json, void (*element)(void *context, Reader &reader), void *context) const
+    {
+        Reader reader(json);
+        reader.expect('[');
+        if (reader.consume(']'))
+            return 0;
+
+        std::size_t count = 0;
+        do
+        {
+            element(context, reader);
+            ++count;
+        } while (reader.consume(','));
+
+        reader.expect(']');
+        return count;
+    }
+
+    void JsonCodec::writeObject(const void *instance, std::string &out) const
+    {
+        out.push_back('{');
+
+        for (std::size_t i = 0; i < _fields.size(); ++i)
+        {
+            if (i)
+                out.push_back(',');
+
+            out += _fields[i].prefix;
+            _fields[i].write(*_fields[i].property, instance, out);
+        }
+
+        out.push_back('}');
+    }
+}
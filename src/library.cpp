@@ -1,15 +1,215 @@
 #include "reflection/library.h"
 
-#include <unordered_map>
+#include <deque>
+#include <mutex>
+#include <atomic>
 #include <algorithm>
 
 #include "reflection/exceptions.h"
+#include "reflection/perfect_hash.h"
+#include "reflection/declaration.h"
 
 namespace lh::reflection
 {
+    // Readers never lock: they load the currently published tables and probe them with acquire loads.
+    // Writers serialize on a mutex, insert into the open-addressing table in place and publish a new,
+    // larger table when it gets half full. Replaced tables are retired instead of freed, because readers
+    // may still be probing them; since tables double in size, retired tables never take up more memory
+    // than the current one.
     struct Library::State
     {
-        std::unordered_map<std::string, const MetaObject *> metaObjects;
+        struct Entry
+        {
+            Entry(Symbol symbol, const MetaObject *metaObject) noexcept :
+                hash(symbol.hash()),
+                name(symbol.name()),
+                symbol(symbol),
+                metaObject(metaObject)
+            {
+            }
+
+            Entry(Symbol symbol, builder_t builder) noexcept :
+                hash(symbol.hash()),
+                name(symbol.name()),
+                symbol(symbol),
+                metaObject(nullptr),
+                builder(builder)
+            {
+            }
+
+            // Declared types are not interned, which keeps adding them down to hashing their names
+            explicit Entry(const TypeDeclaration *declaration) noexcept :
+                hash(std::hash<std::string_view>{}(declaration->name)),
+                name(declaration->name),
+                metaObject(nullptr),
+                declaration(declaration)
+            {
+            }
+
+            std::size_t hash;
+            std::string_view name;
+            Symbol symbol;
+            mutable std::atomic<const MetaObject *> metaObject;
+
+            // Declared and built types are materialized into owned on first use
+            const TypeDeclaration *declaration = nullptr;
+            builder_t builder = nullptr;
+            mutable std::once_flag materialized;
+            mutable std::unique_ptr<MetaObject> owned;
+
+            bool lazy() const noexcept { return declaration || builder; }
+        };
+
+        struct Table
+        {
+            explicit Table(std::size_t capacity) :
+                mask(capacity - 1),
+                slots(std::make_unique<std::atomic<const Entry *>[]>(capacity))
+            {
+            }
+
+            std::size_t mask;
+            std::unique_ptr<std::atomic<const Entry *>[]> slots;
+            std::size_t size = 0;
+        };
+
+        struct Index
+        {
+            utility::perfect_hash hash;
+            std::vector<const Entry *> slots;
+        };
+
+        State() :
+            current(tables.emplace_back(std::make_unique<Table>(16)).get())
+        {
+        }
+
+        template <typename Match>
+        const Entry *find(std::size_t hash, Match match) const noexcept
+        {
+            // An empty library finalizes to an index without slots, there is nothing to probe
+            if (auto index = finalized.load(std::memory_order_acquire); index && !index->slots.empty())
+                if (auto entry = index->slots[index->hash.slot(hash)]; entry && match(*entry))
+                    return entry;
+
+            auto table = current.load(std::memory_order_acquire);
+            for (auto position = hash & table->mask;; position = (position + 1) & table->mask)
+            {
+                auto entry = table->slots[position].load(std::memory_order_acquire);
+                if (!entry)
+                    return nullptr;
+
+                if (match(*entry))
+                    return entry;
+            }
+        }
+
+        const Entry *find(std::string_view name) const noexcept
+        {
+            const auto hash = std::hash<std::string_view>{}(name);
+            return find(hash, [hash, name](const Entry &entry) { return entry.hash == hash && entry.name == name; });
+        }
+
+        // Declared entries have no symbol, they match by name. The empty symbol names no type.
+        const Entry *find(Symbol name) const noexcept
+        {
+            if (!name)
+                return nullptr;
+
+            return find(name.hash(), [name](const Entry &entry) {
+                return entry.symbol ? entry.symbol == name : entry.hash == name.hash() && entry.name == name.name();
+            });
+        }
+
+        static const MetaObject &resolve(const Library &library, const Entry &entry)
+        {
+            if (auto metaObject = entry.metaObject.load(std::memory_order_acquire)) [[likely]]
+                return *metaObject;
+
+            return materialize(library, entry);
+        }
+
+        // Concurrent first uses wait for the one building the type. Bases are looked up, and thereby
+        // materialized, in the same library.
+        static const MetaObject &materialize(const Library &library, const Entry &entry)
+        {
+            std::call_once(entry.materialized, [&library, &entry] {
+                std::unique_ptr<MetaObject> built;
+
+                if (entry.declaration)
+                {
+                    std::vector<const MetaObject *> bases;
+                    for (const auto *base : entry.declaration->bases)
+                        bases.push_back(&library.metaObject(base->name));
+
+                    built = entry.declaration->materialize(std::move(bases));
+                }
+                else
+                {
+                    built = entry.builder(entry.name, library);
+                }
+
+                if (!built || built->name() != entry.name)
+                    throw registration_failed("builder of type " + std::string(entry.name) + " built " + (built ? "type " + built->name() : "nothing"));
+
+                entry.owned = std::move(built);
+                entry.metaObject.store(entry.owned.get(), std::memory_order_release);
+            });
+
+            return *entry.metaObject.load(std::memory_order_acquire);
+        }
+
+        // Writers only, with mutex held
+        void insert(const Entry *entry)
+        {
+            if (auto table = tables.back().get(); 2 * (table->size + 1) > table->mask + 1)
+                grow(2 * (table->mask + 1), entry);
+
+            place(*tables.back(), entry);
+        }
+
+        // Grows the table once for a batch of entries about to be inserted
+        void reserve(std::size_t additional)
+        {
+            const auto table = tables.back().get();
+
+            auto capacity = table->mask + 1;
+            while (2 * (table->size + additional) > capacity)
+                capacity <<= 1;
+
+            if (capacity > table->mask + 1)
+                grow(capacity, nullptr);
+        }
+
+        // Publishes a larger table with all entries but the pending one, which the caller places
+        void grow(std::size_t capacity, const Entry *pending)
+        {
+            auto &grown = tables.emplace_back(std::make_unique<Table>(capacity));
+            for (const auto &existing : entries)
+                if (&existing != pending)
+                    place(*grown, &existing);
+
+            current.store(grown.get(), std::memory_order_release);
+        }
+
+        static void place(Table &table, const Entry *entry) noexcept
+        {
+            auto position = entry->hash & table.mask;
+            while (table.slots[position].load(std::memory_order_relaxed))
+                position = (position + 1) & table.mask;
+
+            table.slots[position].store(entry, std::memory_order_release);
+            ++table.size;
+        }
+
+        mutable std::mutex mutex;
+        std::deque<Entry> entries;
+
+        std::vector<std::unique_ptr<Table>> tables;
+        std::atomic<const Table *> current;
+
+        std::vector<std::unique_ptr<Index>> indexes;
+        std::atomic<const Index *> finalized = nullptr;
     };
 
     Library::Library() noexcept : d(std::make_unique<State>())
@@ -30,29 +230,166 @@ namespace lh::reflection
 
     void Library::add(const MetaObject *_metaObject)
     {
-        if (exists(_metaObject->name()))
-            throw registration_failed("type " + _metaObject->name() + " is already registered (hashes " + (*_metaObject == metaObject(_metaObject->name()) ? "" : "do not") + " match)");
+        std::lock_guard lock(d->mutex);
 
-        d->metaObjects[_metaObject->name()] = _metaObject;
+        const auto name = _metaObject->name();
+        if (auto entry = d->find(std::string_view(name)))
+        {
+            // Types registered lazily are compared only once materialized, builders must not run under the lock
+            std::string match;
+            if (auto existing = entry->metaObject.load(std::memory_order_acquire))
+                match = std::string(" (hashes ") + (*_metaObject == *existing ? "" : "do not ") + "match)";
+
+            throw registration_failed("type " + name + " is already registered" + match);
+        }
+
+        d->insert(&d->entries.emplace_back(Symbol::intern(_metaObject->name()), _metaObject));
     }
 
-    bool Library::exists(std::string name) const noexcept
+    void Library::add(const TypeDeclaration &declaration)
     {
-        return d->metaObjects.contains(name);
+        const TypeDeclaration *declarations[] = {&declaration};
+        add(declarations);
     }
 
-    std::vector<const MetaObject *> Library::metaObjects() const noexcept
+    void Library::add(std::span<const TypeDeclaration *const> declarations)
     {
+        std::lock_guard lock(d->mutex);
+        d->reserve(declarations.size());
+
+        for (const auto *declaration : declarations)
+        {
+            if (exists(declaration->name))
+                throw registration_failed("type " + std::string(declaration->name) + " is already registered");
+
+            d->insert(&d->entries.emplace_back(declaration));
+        }
+    }
+
+    void Library::add(std::string_view name, builder_t builder)
+    {
+        std::lock_guard lock(d->mutex);
+
+        if (exists(name))
+            throw registration_failed("type " + std::string(name) + " is already registered");
+
+        d->insert(&d->entries.emplace_back(Symbol::intern(name), builder));
+    }
+
+    bool Library::exists(std::string_view name) const noexcept
+    {
+        return d->find(name) != nullptr;
+    }
+
+    bool Library::exists(Symbol name) const noexcept
+    {
+        return d->find(name) != nullptr;
+    }
+
+    std::vector<const MetaObject *> Library::metaObjects() const
+    {
+        std::vector<const State::Entry *> entries;
+
+        {
+            std::lock_guard lock(d->mutex);
+            entries.reserve(d->entries.size());
+            std::ranges::transform(d->entries, std::back_inserter(entries), [](const auto &entry) { return &entry; });
+        }
+
         std::vector<const MetaObject *> metaObjects;
-        std::ranges::transform(d->metaObjects, metaObjects.begin(), [](const auto &pair) { return pair.second; });
+        metaObjects.reserve(entries.size());
+        std::ranges::transform(entries, std::back_inserter(metaObjects), [this](const auto *entry) { return &State::resolve(*this, *entry); });
         return metaObjects;
     }
 
-    const MetaObject &Library::metaObject(std::string name) const
+    std::vector<const MetaObject *> Library::materialized() const
     {
-        if (auto where = d->metaObjects.find(name); where != d->metaObjects.end())
-            return *where->second;
+        std::lock_guard lock(d->mutex);
+
+        std::vector<const MetaObject *> metaObjects;
+        for (const auto &entry : d->entries)
+            if (auto metaObject = entry.metaObject.load(std::memory_order_acquire))
+                metaObjects.push_back(metaObject);
+
+        return metaObjects;
+    }
+
+    const MetaObject &Library::metaObject(std::string_view name) const
+    {
+        if (auto entry = d->find(name))
+            return State::resolve(*this, *entry);
+
+        throw unknown_type(std::string(name));
+    }
+
+    const MetaObject &Library::metaObject(Symbol name) const
+    {
+        if (auto entry = d->find(name))
+            return State::resolve(*this, *entry);
+
+        throw unknown_type(std::string(name.name()));
+    }
+
+    const MetaObject *Library::findMetaObject(std::string_view name) const
+    {
+        auto entry = d->find(name);
+        return entry ? &State::resolve(*this, *entry) : nullptr;
+    }
+
+    const MetaObject *Library::findMetaObject(Symbol name) const
+    {
+        auto entry = d->find(name);
+        return entry ? &State::resolve(*this, *entry) : nullptr;
+    }
+
+    void Library::finalize()
+    {
+        std::lock_guard lock(d->mutex);
+
+        std::vector<std::uint64_t> hashes;
+        hashes.reserve(d->entries.size());
+        std::ranges::transform(d->entries, std::back_inserter(hashes), [](const auto &entry) { return entry.hash; });
+
+        auto index = std::make_unique<State::Index>();
+        index->hash = utility::perfect_hash(hashes);
+        index->slots.resize(index->hash.slots(), nullptr);
+
+        // Names with colliding 64-bit hashes share a slot, the ones left out are found through the table
+        for (const auto &entry : d->entries)
+            if (auto &slot = index->slots[index->hash.slot(entry.hash)]; !slot)
+                slot = &entry;
+
+        d->finalized.store(d->indexes.emplace_back(std::move(index)).get(), std::memory_order_release);
+    }
+
+    bool Library::finalized() const noexcept
+    {
+        return d->finalized.load(std::memory_order_acquire) != nullptr;
+    }
+
+    MemoryUsage Library::memoryUsage() const
+    {
+        MemoryUsage usage;
+
+        for (const auto metaObject : materialized())
+            usage += metaObject->memoryUsage();
+
+        std::lock_guard lock(d->mutex);
+
+        // Entries are counted as far as in use, the deque allocates them in blocks
+        usage.tables += d->entries.size() * sizeof(State::Entry);
+        for (const auto &entry : d->entries)
+            if (entry.lazy() && entry.metaObject.load(std::memory_order_acquire))
+                usage.tables += sizeof(MetaObject);
+
+        usage.tables += utility::heapSize(d->tables);
+        for (const auto &table : d->tables)
+            usage.tables += sizeof(State::Table) + (table->mask + 1) * sizeof(std::atomic<const State::Entry *>);
+
+        usage.tables += utility::heapSize(d->indexes);
+        for (const auto &index : d->indexes)
+            usage.tables += sizeof(State::Index) + index->hash.displacements().size_bytes() + utility::heapSize(index->slots);
 
-        throw unknown_type(name);
+        return usage;
     }
 }
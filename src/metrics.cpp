@@ -0,0 +1,249 @@
+#include "reflection/metrics.h"
+
+#include <new>
+#include <bit>
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include "reflection/library.h"
+
+namespace lh::reflection
+{
+    struct alignas(64) Metrics::Shard
+    {
+        std::atomic<std::uint64_t> calls = 0;
+        std::atomic<std::uint64_t> samples = 0;
+        std::atomic<std::uint64_t> nanoseconds = 0;
+        std::array<std::atomic<std::uint64_t>, buckets> histogram{};
+    };
+
+    std::atomic<bool> Metrics::_enabled = false;
+
+    namespace
+    {
+        std::atomic<std::uint32_t> sampling = 0;
+
+        // Shard of the current thread, assigned round robin
+        std::size_t shardIndex() noexcept
+        {
+            static std::atomic<std::size_t> next = 0;
+            thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed) % Metrics::shards;
+            return index;
+        }
+
+        bool sampled() noexcept
+        {
+            thread_local std::uint32_t countdown = 1;
+
+            const auto every = sampling.load(std::memory_order_relaxed);
+            if (!every || --countdown)
+                return false;
+
+            countdown = every;
+            return true;
+        }
+
+        std::int64_t now() noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+    }
+
+    std::size_t Metrics::Snapshot::bucket(std::uint64_t nanoseconds) noexcept
+    {
+        if (nanoseconds < 4)
+            return static_cast<std::size_t>(nanoseconds);
+
+        const auto exponent = static_cast<std::size_t>(std::bit_width(nanoseconds) - 1);
+        const auto bucket = 4 * (exponent - 1) + ((nanoseconds >> (exponent - 2)) & 3);
+        return std::min(bucket, buckets - 1);
+    }
+
+    std::uint64_t Metrics::Snapshot::lowerBound(std::size_t bucket) noexcept
+    {
+        if (bucket < 4)
+            return bucket;
+
+        const auto exponent = bucket / 4 + 1;
+        return (std::uint64_t(4) | (bucket & 3)) << (exponent - 2);
+    }
+
+    std::uint64_t Metrics::Snapshot::percentile(double fraction) const noexcept
+    {
+        const auto target = static_cast<std::uint64_t>(fraction * static_cast<double>(samples));
+
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < buckets; ++i)
+        {
+            seen += histogram[i];
+            if (seen > target)
+                return lowerBound(i);
+        }
+
+        return samples ? lowerBound(buckets - 1) : 0;
+    }
+
+    Metrics::Metrics(Metrics &&other) noexcept :
+        _shards(other._shards.exchange(nullptr, std::memory_order_relaxed))
+    {
+    }
+
+    Metrics &Metrics::operator=(Metrics &&other) noexcept
+    {
+        if (this != &other)
+            delete[] _shards.exchange(other._shards.exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+
+        return *this;
+    }
+
+    Metrics::~Metrics()
+    {
+        delete[] _shards.load(std::memory_order_relaxed);
+    }
+
+    void Metrics::enable(bool enabled) noexcept
+    {
+        _enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    void Metrics::sample(std::uint32_t every) noexcept
+    {
+        sampling.store(every, std::memory_order_relaxed);
+    }
+
+    Metrics::Snapshot Metrics::snapshot() const noexcept
+    {
+        Snapshot snapshot;
+
+        if (auto shards = _shards.load(std::memory_order_acquire))
+        {
+            for (std::size_t i = 0; i < Metrics::shards; ++i)
+            {
+                snapshot.calls += shards[i].calls.load(std::memory_order_relaxed);
+                snapshot.samples += shards[i].samples.load(std::memory_order_relaxed);
+                snapshot.nanoseconds += shards[i].nanoseconds.load(std::memory_order_relaxed);
+
+                for (std::size_t j = 0; j < buckets; ++j)
+                    snapshot.histogram[j] += shards[i].histogram[j].load(std::memory_order_relaxed);
+            }
+        }
+
+        return snapshot;
+    }
+
+    void Metrics::reset() const noexcept
+    {
+        if (auto shards = _shards.load(std::memory_order_acquire))
+        {
+            for (std::size_t i = 0; i < Metrics::shards; ++i)
+            {
+                shards[i].calls.store(0, std::memory_order_relaxed);
+                shards[i].samples.store(0, std::memory_order_relaxed);
+                shards[i].nanoseconds.store(0, std::memory_order_relaxed);
+
+                for (auto &count : shards[i].histogram)
+                    count.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::size_t Metrics::allocated() const noexcept
+    {
+        return _shards.load(std::memory_order_relaxed) ? Metrics::shards * sizeof(Shard) : 0;
+    }
+
+    Metrics::Shard *Metrics::begin(std::int64_t &start) const noexcept
+    {
+        auto shard = this->shard();
+        if (!shard)
+            return nullptr;
+
+        shard->calls.fetch_add(1, std::memory_order_relaxed);
+
+        if (sampled())
+            start = now();
+
+        return shard;
+    }
+
+    void Metrics::end(Shard *shard, std::int64_t start) noexcept
+    {
+        const auto elapsed = static_cast<std::uint64_t>(std::max<std::int64_t>(now() - start, 0));
+
+        shard->samples.fetch_add(1, std::memory_order_relaxed);
+        shard->nanoseconds.fetch_add(elapsed, std::memory_order_relaxed);
+        shard->histogram[Snapshot::bucket(elapsed)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Metrics::add(std::uint64_t calls) const noexcept
+    {
+        if (auto shard = this->shard())
+            shard->calls.fetch_add(calls, std::memory_order_relaxed);
+    }
+
+    Metrics::Shard *Metrics::shard() const noexcept
+    {
+        auto shards = _shards.load(std::memory_order_acquire);
+
+        if (!shards) [[unlikely]]
+        {
+            // Metrics are best effort, calls go on uncounted if the shards cannot be allocated
+            auto allocated = new (std::nothrow) Shard[Metrics::shards];
+            if (!allocated)
+                return nullptr;
+
+            if (_shards.compare_exchange_strong(shards, allocated, std::memory_order_acq_rel))
+                shards = allocated;
+            else
+                delete[] allocated;
+        }
+
+        return shards + shardIndex();
+    }
+
+    std::vector<MemberMetrics> Library::metrics() const
+    {
+        std::vector<MemberMetrics> metrics;
+
+#ifdef REFLECTION_METRICS
+        const auto record = [&metrics](const MetaObject *type, std::string member, MemberMetrics::Kind kind, std::string signature, const Metrics &source) {
+            if (auto snapshot = source.snapshot(); snapshot.calls)
+                metrics.push_back(MemberMetrics{type->name(), std::move(member), kind, std::move(signature), snapshot});
+        };
+
+        for (const auto type : materialized())
+        {
+            for (const auto method : type->methods())
+                for (const auto overload : method->overloads())
+                    record(type, method->name(), MemberMetrics::Kind::Method, utility::signatureString(overload->argumentTypes()), overload->metrics());
+
+            for (const auto property : type->properties())
+                record(type, property->name(), MemberMetrics::Kind::Property, property->type().name(), property->metrics());
+
+            for (const auto event : type->events())
+                record(type, event->name(), MemberMetrics::Kind::Event, utility::signatureString(event->argumentTypes()), event->metrics());
+        }
+#endif
+
+        return metrics;
+    }
+
+    void Library::resetMetrics() const
+    {
+#ifdef REFLECTION_METRICS
+        for (const auto type : materialized())
+        {
+            for (const auto method : type->methods())
+                for (const auto overload : method->overloads())
+                    overload->metrics().reset();
+
+            for (const auto property : type->properties())
+                property->metrics().reset();
+
+            for (const auto event : type->events())
+                event->metrics().reset();
+        }
+#endif
+    }
+}
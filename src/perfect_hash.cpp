@@ -0,0 +1,80 @@
+#include "reflection/perfect_hash.h"
+
+#include <bit>
+#include <algorithm>
+
+namespace lh::reflection::utility
+{
+    perfect_hash::perfect_hash(std::span<const std::uint64_t> hashes)
+    {
+        std::vector<std::uint64_t> unique(hashes.begin(), hashes.end());
+        std::ranges::sort(unique);
+        unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+
+        if (unique.empty())
+            return;
+
+        // Start at a load factor of at most 0.8 and grow the table until every bucket can be placed
+        auto slots = std::bit_ceil(unique.size() + unique.size() / 4);
+        while (!build(unique, slots))
+            slots *= 2;
+    }
+
+    bool perfect_hash::build(std::span<const std::uint64_t> hashes, std::size_t slots)
+    {
+        constexpr std::uint64_t golden = 0x9e3779b97f4a7c15;
+        constexpr std::uint64_t attempts = 1 << 16;
+
+        _mask = slots - 1;
+        _displacements.assign(std::max<std::size_t>(1, hashes.size() / 4), 0);
+
+        std::vector<std::vector<std::uint64_t>> buckets(_displacements.size());
+        for (auto hash : hashes)
+            buckets[bucket(hash, _displacements.size())].push_back(hash);
+
+        std::vector<std::size_t> order(buckets.size());
+        for (std::size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+
+        // Largest buckets first, while most slots are still free
+        std::ranges::stable_sort(order, std::greater<>(), [&buckets](auto index) { return buckets[index].size(); });
+
+        std::vector<bool> occupied(slots, false);
+        std::vector<std::size_t> placed;
+
+        for (auto index : order)
+        {
+            const auto &keys = buckets[index];
+            if (keys.empty())
+                break;
+
+            bool found = false;
+            for (std::uint64_t attempt = 0; attempt < attempts && !found; ++attempt)
+            {
+                const auto displacement = attempt * golden;
+                placed.clear();
+
+                found = std::ranges::all_of(keys, [&](auto hash) {
+                    const auto slot = static_cast<std::size_t>(mix(hash ^ displacement) & _mask);
+                    if (occupied[slot] || std::ranges::find(placed, slot) != placed.end())
+                        return false;
+
+                    placed.push_back(slot);
+                    return true;
+                });
+
+                if (found)
+                {
+                    _displacements[index] = displacement;
+                    for (auto slot : placed)
+                        occupied[slot] = true;
+                }
+            }
+
+            if (!found)
+                return false;
+        }
+
+        return true;
+    }
+}
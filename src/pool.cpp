@@ -0,0 +1,41 @@
+#include "reflection/pool.h"
+
+#include <algorithm>
+
+namespace lh::reflection
+{
+    Pool::Pool(const MetaObject &metaObject, std::pmr::memory_resource *upstream) :
+        _metaObject(metaObject),
+        _upstream(upstream),
+        _blockSize(std::max(metaObject.instanceSize(), sizeof(Node))),
+        _blockAlignment(std::max(metaObject.instanceAlignment(), alignof(Node)))
+    {
+        if (!metaObject.instanceSize())
+            throw instantiation_failed("type " + metaObject.name() + " has no constructor that can construct in place");
+
+        _blockSize = (_blockSize + _blockAlignment - 1) / _blockAlignment * _blockAlignment;
+    }
+
+    Pool::~Pool()
+    {
+        for (auto [chunk, size] : _chunks)
+            _upstream->deallocate(chunk, size, _blockAlignment);
+    }
+
+    void Pool::grow()
+    {
+        // Chunks double with the capacity, from 8 up to 1024 blocks
+        const auto blocks = std::clamp<std::size_t>(_capacity, 8, 1024);
+        const auto size = blocks * _blockSize;
+
+        _chunks.reserve(_chunks.size() + 1);
+        auto chunk = static_cast<std::byte *>(_upstream->allocate(size, _blockAlignment));
+        _chunks.emplace_back(chunk, size);
+
+        // Pushed backwards, so that blocks are handed out in address order
+        for (auto i = blocks; i-- > 0;)
+            give(chunk + i * _blockSize);
+
+        _capacity += blocks;
+    }
+}
@@ -1,3 +0,0 @@
-#include "reflection/reflectable.h"
-
-lh::reflection::MetaObject lh::reflection::Reflectable::_metaObject("Reflectable", typeid(Reflectable));
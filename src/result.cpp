@@ -0,0 +1,43 @@
+#include "reflection/result.h"
+
+#include "reflection/exceptions.h"
+
+namespace lh::reflection
+{
+    std::string Failure::message() const
+    {
+        const auto name = std::string(_name);
+
+        switch (_error)
+        {
+        case Error::UnknownSignature:
+            return "unknown signature " + name + "(" + (_signature ? _signature() : std::string()) + ") for method " + name;
+        case Error::InvalidMethodType:
+            return "type " + std::string(_type) + " is incompatible with return type " + std::string(_expected) + " for method " + name;
+        case Error::InvalidPropertyType:
+            return "type " + std::string(_type) + " is incompatible with type " + std::string(_expected) + " of property " + name;
+        default:
+            return name;
+        }
+    }
+
+    void Failure::raise() const
+    {
+        switch (_error)
+        {
+        case Error::UnknownType:
+            throw unknown_type(message());
+        case Error::UnknownMethod:
+        case Error::UnknownSignature:
+            throw unknown_method(message());
+        case Error::InvalidMethodType:
+            throw invalid_method_type(message());
+        case Error::UnknownProperty:
+            throw unknown_property(message());
+        case Error::InvalidPropertyType:
+            throw invalid_property_type(message());
+        }
+
+        throw reflection_error(message());
+    }
+}
@@ -0,0 +1,231 @@
+#include "reflection/serializer.h"
+
+#include <bit>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+namespace lh::reflection
+{
+    namespace
+    {
+        template <typename T>
+        void store(T value, std::byte *out) noexcept
+        {
+            std::memcpy(out, &value, sizeof(T));
+
+            if constexpr (std::endian::native == std::endian::big)
+                std::reverse(out, out + sizeof(T));
+        }
+
+        template <typename T>
+        T load(const std::byte *in) noexcept
+        {
+            T value;
+            std::memcpy(&value, in, sizeof(T));
+
+            if constexpr (std::endian::native == std::endian::big)
+            {
+                auto bytes = reinterpret_cast<std::byte *>(&value);
+                std::reverse(bytes, bytes + sizeof(T));
+            }
+
+            return value;
+        }
+
+        // Fixed size encoders rely on the caller to check the bounds
+        template <typename T>
+        std::byte *encodeValue(const Property &property, const void *instance, std::byte *out, std::byte *)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+                out[0] = std::byte(property.get<void, bool>(instance) ? 1 : 0);
+            else
+                store(property.get<void, T>(instance), out);
+
+            return out + sizeof(T);
+        }
+
+        template <typename T>
+        const std::byte *decodeValue(const Property &property, void *instance, const std::byte *in, const std::byte *)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+                property.set<void, bool>(instance, in[0] != std::byte(0));
+            else
+                property.set<void, T>(instance, load<T>(in));
+
+            return in + sizeof(T);
+        }
+
+        std::byte *encodeString(const Property &property, const void *instance, std::byte *out, std::byte *end)
+        {
+            // Properties read by reference are written without copying the string first
+            const auto copy = property.byReference() ? std::string() : property.get<void, std::string>(instance);
+            const auto value = property.byReference() ? property.get<void, std::string_view>(instance) : std::string_view(copy);
+            if (static_cast<std::size_t>(end - out) < sizeof(std::uint32_t) + value.size())
+                return nullptr;
+
+            store(static_cast<std::uint32_t>(value.size()), out);
+            std::memcpy(out + sizeof(std::uint32_t), value.data(), value.size());
+            return out + sizeof(std::uint32_t) + value.size();
+        }
+
+        const std::byte *decodeString(const Property &property, void *instance, const std::byte *in, const std::byte *end)
+        {
+            if (static_cast<std::size_t>(end - in) < sizeof(std::uint32_t))
+                return nullptr;
+
+            const auto size = load<std::uint32_t>(in);
+            in += sizeof(std::uint32_t);
+
+            if (static_cast<std::size_t>(end - in) < size)
+                return nullptr;
+
+            property.set<void, std::string>(instance, std::string(reinterpret_cast<const char *>(in), size));
+            return in + size;
+        }
+    }
+
+    Serializer::Serializer(const MetaObject &metaObject) :
+        _name(metaObject.name())
+    {
+        auto properties = metaObject.properties();
+        std::ranges::sort(properties, [](const Property *a, const Property *b) { return a->name() < b->name(); });
+
+        for (const auto *property : properties)
+        {
+            auto fixed = [&]<typename... Ts>(std::type_identity<Ts>...) {
+                return ((property->hash() == utility::typeId<Ts>() && (_fields.push_back(Field{property, sizeof(Ts), 0, &encodeValue<Ts>, &decodeValue<Ts>, &encodeColumn<Ts>}), true)) || ...);
+            };
+
+            if (fixed(std::type_identity<bool>(), std::type_identity<char>(),
+                      std::type_identity<std::int8_t>(), std::type_identity<std::uint8_t>(),
+                      std::type_identity<std::int16_t>(), std::type_identity<std::uint16_t>(),
+                      std::type_identity<std::int32_t>(), std::type_identity<std::uint32_t>(),
+                      std::type_identity<std::int64_t>(), std::type_identity<std::uint64_t>(),
+                      std::type_identity<float>(), std::type_identity<double>()))
+                continue;
+
+            if (property->hash() == utility::typeId<std::string>())
+            {
+                _fields.push_back(Field{property, 0, 0, &encodeString, &decodeString, nullptr});
+                continue;
+            }
+
+            throw serialization_failed("property " + property->name() + " of " + _name + " has unsupported type " + property->type().name());
+        }
+
+        if (std::ranges::all_of(_fields, [](const Field &field) { return field.size != 0; }))
+        {
+            for (auto &field : _fields)
+            {
+                field.offset = _fixedSize;
+                _fixedSize += field.size;
+            }
+
+            _columnar = std::endian::native == std::endian::little;
+        }
+
+        if (!_columnar)
+            return;
+
+        // Blocks only serve instances encoded one at a time, bulk encoding is faster with the fixed
+        // size copies of gathering one property at a time. Booleans are left out since decoding has
+        // to normalize them.
+        auto copyable = [](const Field &field) {
+            const auto &layout = field.property->layout();
+            return layout && layout->triviallyCopyable && layout->size == field.size && field.property->hash() != utility::typeId<bool>();
+        };
+
+        for (const auto &field : _fields)
+        {
+            if (!copyable(field))
+            {
+                _blocks.push_back(field);
+                continue;
+            }
+
+            const auto source = field.property->layout()->offset;
+            if (!_blocks.empty() && _blocks.back().copy && _blocks.back().source + _blocks.back().size == source)
+            {
+                _blocks.back().size += field.size;
+                continue;
+            }
+
+            _blocks.push_back(field);
+            _blocks.back().copy = true;
+            _blocks.back().source = source;
+        }
+    }
+
+    void Serializer::encodeColumns(const void *instances, std::size_t stride, std::byte *out, std::size_t count) const
+    {
+        for (const auto &field : _fields)
+            field.column(*field.property, instances, stride, out + field.offset, _fixedSize, count);
+    }
+
+    std::optional<std::size_t> Serializer::tryEncode(const void *instance, std::span<std::byte> out) const
+    {
+        auto position = out.data();
+        const auto end = out.data() + out.size();
+
+        if (_fixedSize)
+        {
+            if (out.size() < _fixedSize)
+                return std::nullopt;
+
+            for (const auto &field : _columnar ? _blocks : _fields)
+            {
+                if (!field.copy)
+                {
+                    position = field.encode(*field.property, instance, position, end);
+                    continue;
+                }
+
+                std::memcpy(position, static_cast<const std::byte *>(instance) + field.source, field.size);
+                position += field.size;
+            }
+
+            return _fixedSize;
+        }
+
+        for (const auto &field : _fields)
+        {
+            if (field.size > static_cast<std::size_t>(end - position))
+                return std::nullopt;
+
+            position = field.encode(*field.property, instance, position, end);
+            if (!position)
+                return std::nullopt;
+        }
+
+        return static_cast<std::size_t>(position - out.data());
+    }
+
+    std::size_t Serializer::decodeInstance(void *instance, std::span<const std::byte> in) const
+    {
+        auto position = in.data();
+        const auto end = in.data() + in.size();
+
+        if (_fixedSize && in.size() < _fixedSize)
+            throw serialization_failed("input of " + std::to_string(in.size()) + " bytes is too short for " + _name);
+
+        for (const auto &field : _columnar ? _blocks : _fields)
+        {
+            if (!_fixedSize && field.size > static_cast<std::size_t>(end - position))
+                position = nullptr;
+            else if (field.copy)
+            {
+                std::memcpy(static_cast<std::byte *>(instance) + field.source, position, field.size);
+                position += field.size;
+            }
+            else
+                position = field.decode(*field.property, instance, position, end);
+
+            if (!position)
+                throw serialization_failed("input of " + std::to_string(in.size()) + " bytes is truncated at property " + field.property->name() + " of " + _name);
+        }
+
+        return static_cast<std::size_t>(position - in.data());
+    }
+}
@@ -0,0 +1,448 @@
+#include "reflection/snapshot.h"
+
+#include <limits>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <unordered_map>
+
+#include "reflection/library.h"
+#include "reflection/perfect_hash.h"
+
+#ifdef WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace lh::reflection
+{
+    // Offsets of records are relative to the start of the image, offsets of strings to the string pool
+    struct SchemaSnapshot::Header
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrder;
+        std::uint64_t size;
+        std::uint64_t contentHash;
+        Range types;
+        Range slots;
+        Range displacements;
+        Range strings;
+        std::uint64_t mask;
+    };
+
+    namespace
+    {
+        constexpr char magic[8] = {'L', 'H', 'S', 'C', 'H', 'E', 'M', 'A'};
+        constexpr std::uint32_t byteOrder = 0x01020304;
+        constexpr std::uint32_t emptySlot = std::numeric_limits<std::uint32_t>::max();
+
+        // Records are copied into the image byte for byte, padding would make equal schemas hash differently
+        template <typename T>
+        constexpr bool is_record_v = std::is_trivially_copyable_v<T> && std::has_unique_object_representations_v<T> && alignof(T) <= 8;
+
+        class Writer
+        {
+        public:
+            using Range = SchemaSnapshot::Range;
+            using String = SchemaSnapshot::String;
+            using TypeReference = SchemaSnapshot::TypeReference;
+
+            explicit Writer(std::size_t header) :
+                _image(header)
+            {
+            }
+
+            // Every table starts 8-byte aligned and is zero filled
+            template <typename T>
+            Range allocate(std::size_t count)
+            {
+                static_assert(is_record_v<T>);
+
+                const auto offset = _image.size();
+                _image.resize(offset + (count * sizeof(T) + 7) / 8 * 8);
+                return Range{checked(offset), checked(count)};
+            }
+
+            template <typename T>
+            void put(Range range, std::size_t index, const T &record) noexcept
+            {
+                std::memcpy(_image.data() + range.offset + index * sizeof(T), &record, sizeof(T));
+            }
+
+            String string(const std::string &value)
+            {
+                auto [where, inserted] = _strings.try_emplace(value, String{checked(_pool.size()), checked(value.size())});
+                if (inserted)
+                    _pool.append(value);
+
+                return where->second;
+            }
+
+            TypeReference reference(std::type_index type)
+            {
+                return TypeReference{SchemaSnapshot::fingerprint(type), string(type.name())};
+            }
+
+            Range references(const std::vector<std::type_index> &types)
+            {
+                const auto range = allocate<TypeReference>(types.size());
+                for (std::size_t i = 0; i < types.size(); ++i)
+                    put(range, i, reference(types[i]));
+
+                return range;
+            }
+
+            // Appends the string pool and hands out the image, leaving the header to the caller
+            std::vector<std::byte> finish(Range &strings)
+            {
+                strings = Range{checked(_image.size()), checked(_pool.size())};
+                _image.resize(_image.size() + (_pool.size() + 7) / 8 * 8);
+                std::memcpy(_image.data() + strings.offset, _pool.data(), _pool.size());
+                return std::move(_image);
+            }
+
+        private:
+            static std::uint32_t checked(std::size_t value)
+            {
+                if (value > std::numeric_limits<std::uint32_t>::max())
+                    throw reflection_error("schema snapshot exceeds the 4 GiB image limit");
+
+                return static_cast<std::uint32_t>(value);
+            }
+
+            std::vector<std::byte> _image;
+            std::string _pool;
+            std::unordered_map<std::string, String> _strings;
+        };
+
+        // name() returns a copy, so every name is fetched once rather than on every comparison
+        template <typename T>
+        void sortByName(std::vector<const T *> &members)
+        {
+            std::vector<std::pair<std::string, const T *>> named;
+            named.reserve(members.size());
+            std::ranges::transform(members, std::back_inserter(named), [](const T *member) { return std::pair(member->name(), member); });
+
+            std::ranges::sort(named, {}, &std::pair<std::string, const T *>::first);
+            std::ranges::transform(named, members.begin(), &std::pair<std::string, const T *>::second);
+        }
+    }
+
+    static_assert(is_record_v<SchemaSnapshot::TypeRecord> &&
+                  is_record_v<SchemaSnapshot::ConstructorRecord> && is_record_v<SchemaSnapshot::MethodRecord> &&
+                  is_record_v<SchemaSnapshot::OverloadRecord> && is_record_v<SchemaSnapshot::PropertyRecord> &&
+                  is_record_v<SchemaSnapshot::EventRecord>);
+
+    std::vector<std::byte> SchemaSnapshot::build(std::vector<const MetaObject *> metaObjects)
+    {
+        static_assert(is_record_v<Header>);
+        sortByName(metaObjects);
+
+        Writer writer(sizeof(Header));
+        const auto types = writer.allocate<TypeRecord>(metaObjects.size());
+
+        std::vector<std::uint64_t> hashes;
+        hashes.reserve(metaObjects.size());
+
+        for (std::size_t i = 0; i < metaObjects.size(); ++i)
+        {
+            const auto &metaObject = *metaObjects[i];
+
+            TypeRecord type{};
+            type.nameHash = hashes.emplace_back(utility::fnv1a(metaObject.name()));
+            type.fingerprint = fingerprint(metaObject.type());
+            type.name = writer.string(metaObject.name());
+
+            const auto bases = metaObject.bases();
+            type.bases = writer.allocate<TypeReference>(bases.size());
+            for (std::size_t j = 0; j < bases.size(); ++j)
+                writer.put(type.bases, j, TypeReference{fingerprint(bases[j]->type()), writer.string(bases[j]->name())});
+
+            auto constructors = metaObject.constructors();
+            std::ranges::sort(constructors, {}, &Constructor::hash);
+            type.constructors = writer.allocate<ConstructorRecord>(constructors.size());
+            for (std::size_t j = 0; j < constructors.size(); ++j)
+                writer.put(type.constructors, j, ConstructorRecord{constructors[j]->hash(), writer.references(constructors[j]->argumentTypes())});
+
+            auto methods = metaObject.methods();
+            sortByName(methods);
+            type.methods = writer.allocate<MethodRecord>(methods.size());
+            for (std::size_t j = 0; j < methods.size(); ++j)
+            {
+                auto overloads = methods[j]->overloads();
+                std::ranges::sort(overloads, [](const Method::Overload *a, const Method::Overload *b) {
+                    return std::pair(a->signature(), a->qualifier()) < std::pair(b->signature(), b->qualifier());
+                });
+
+                MethodRecord method{writer.string(methods[j]->name()), writer.allocate<OverloadRecord>(overloads.size())};
+                for (std::size_t k = 0; k < overloads.size(); ++k)
+                {
+                    const auto &overload = *overloads[k];
+                    writer.put(method.overloads, k, OverloadRecord{overload.signature(), writer.reference(overload.returnType()), writer.references(overload.argumentTypes()), static_cast<std::uint32_t>(overload.qualifier()), 0});
+                }
+
+                writer.put(type.methods, j, method);
+            }
+
+            auto properties = metaObject.properties();
+            sortByName(properties);
+            type.properties = writer.allocate<PropertyRecord>(properties.size());
+            for (std::size_t j = 0; j < properties.size(); ++j)
+                writer.put(type.properties, j, PropertyRecord{writer.string(properties[j]->name()), writer.reference(properties[j]->type())});
+
+            auto events = metaObject.events();
+            sortByName(events);
+            type.events = writer.allocate<EventRecord>(events.size());
+            for (std::size_t j = 0; j < events.size(); ++j)
+                writer.put(type.events, j, EventRecord{events[j]->hash(), writer.string(events[j]->name()), writer.references(events[j]->argumentTypes()), static_cast<std::uint32_t>(events[j]->ordinal()), 0});
+
+            writer.put(types, i, type);
+        }
+
+        Header header{};
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version = version;
+        header.byteOrder = byteOrder;
+        header.types = types;
+
+        // Names with colliding 64-bit hashes share a slot, lookups fall back to a binary search for the others
+        const utility::perfect_hash index(hashes);
+        header.mask = index.mask();
+
+        const auto displacements = index.displacements();
+        header.displacements = writer.allocate<std::uint64_t>(displacements.size());
+        for (std::size_t i = 0; i < displacements.size(); ++i)
+            writer.put(header.displacements, i, displacements[i]);
+
+        std::vector<std::uint32_t> slots(index.slots(), emptySlot);
+        for (std::size_t i = 0; i < hashes.size(); ++i)
+            if (auto &slot = slots[index.slot(hashes[i])]; slot == emptySlot)
+                slot = static_cast<std::uint32_t>(i);
+
+        header.slots = writer.allocate<std::uint32_t>(slots.size());
+        for (std::size_t i = 0; i < slots.size(); ++i)
+            writer.put(header.slots, i, slots[i]);
+
+        auto image = writer.finish(header.strings);
+        header.size = image.size();
+        header.contentHash = utility::fnv1a(std::string_view(reinterpret_cast<const char *>(image.data()) + sizeof(Header), image.size() - sizeof(Header)));
+
+        std::memcpy(image.data(), &header, sizeof(Header));
+        return image;
+    }
+
+    SchemaSnapshot::SchemaSnapshot(std::span<const std::byte> image) :
+        _image(image)
+    {
+        if (reinterpret_cast<std::uintptr_t>(image.data()) % alignof(std::uint64_t))
+            throw invalid_snapshot("image is not 8-byte aligned");
+
+        if (image.size() < sizeof(Header))
+            throw invalid_snapshot("image of " + std::to_string(image.size()) + " bytes is too small");
+
+        const auto &header = this->header();
+        if (std::memcmp(header.magic, magic, sizeof(magic)) != 0)
+            throw invalid_snapshot("image is not a schema snapshot");
+
+        if (header.version != version)
+            throw invalid_snapshot("version " + std::to_string(header.version) + " is not supported");
+
+        if (header.byteOrder != byteOrder)
+            throw invalid_snapshot("image was written with a different byte order");
+
+        if (header.size > image.size())
+            throw invalid_snapshot("image of " + std::to_string(image.size()) + " bytes is truncated, expected " + std::to_string(header.size));
+
+        auto within = [&header](Range range, std::uint64_t size) {
+            return range.offset >= sizeof(Header) && range.offset + range.count * size <= header.size;
+        };
+
+        if (!within(header.types, sizeof(TypeRecord)) || !within(header.slots, sizeof(std::uint32_t)) ||
+            !within(header.displacements, sizeof(std::uint64_t)) || !within(header.strings, 1) ||
+            (header.types.count && (!header.displacements.count || header.slots.count != header.mask + 1)))
+            throw invalid_snapshot("header refers outside of the image");
+
+        _image = image.first(header.size);
+        _types = header.types;
+        _slots = range<std::uint32_t>(header.slots);
+        _displacements = range<std::uint64_t>(header.displacements);
+        _mask = header.mask;
+        _strings = header.strings.offset;
+    }
+
+    SchemaSnapshot SchemaSnapshot::map(const std::string &path)
+    {
+#ifdef WIN32
+        const auto file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            throw invalid_snapshot("cannot open " + path);
+
+        LARGE_INTEGER size{};
+        if (!::GetFileSizeEx(file, &size) || static_cast<std::uint64_t>(size.QuadPart) < sizeof(Header))
+        {
+            ::CloseHandle(file);
+            throw invalid_snapshot(path + " is too small");
+        }
+
+        const auto view = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        ::CloseHandle(file);
+        if (!view)
+            throw invalid_snapshot("cannot map " + path);
+
+        const auto data = ::MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0);
+        ::CloseHandle(view);
+        if (!data)
+            throw invalid_snapshot("cannot map " + path);
+
+        std::shared_ptr<const void> mapping(data, [](const void *data) { ::UnmapViewOfFile(data); });
+        SchemaSnapshot snapshot(std::span(static_cast<const std::byte *>(data), static_cast<std::size_t>(size.QuadPart)));
+#else
+        const auto file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file < 0)
+            throw invalid_snapshot("cannot open " + path);
+
+        struct stat status{};
+        if (::fstat(file, &status) != 0 || static_cast<std::uint64_t>(status.st_size) < sizeof(Header))
+        {
+            ::close(file);
+            throw invalid_snapshot(path + " is too small");
+        }
+
+        const auto size = static_cast<std::size_t>(status.st_size);
+        const auto data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0);
+        ::close(file);
+        if (data == MAP_FAILED)
+            throw invalid_snapshot("cannot map " + path);
+
+        std::shared_ptr<const void> mapping(data, [size](const void *data) { ::munmap(const_cast<void *>(data), size); });
+        SchemaSnapshot snapshot(std::span(static_cast<const std::byte *>(data), size));
+#endif
+
+        snapshot._mapping = std::move(mapping);
+        return snapshot;
+    }
+
+    std::uint64_t SchemaSnapshot::contentHash() const noexcept
+    {
+        return header().contentHash;
+    }
+
+    bool SchemaSnapshot::verify() const noexcept
+    {
+        return header().contentHash == utility::fnv1a(std::string_view(reinterpret_cast<const char *>(_image.data()) + sizeof(Header), _image.size() - sizeof(Header)));
+    }
+
+    const SchemaSnapshot::TypeRecord *SchemaSnapshot::find(std::string_view name) const noexcept
+    {
+        if (!_types.count)
+            return nullptr;
+
+        const auto hash = utility::fnv1a(name);
+        const auto index = _slots[utility::perfect_hash::slot(hash, _displacements, _mask)];
+        if (index >= _types.count)
+            return nullptr;
+
+        const auto &type = types()[index];
+        if (type.nameHash != hash)
+            return nullptr;
+
+        if (string(type.name) == name)
+            return &type;
+
+        return named(types(), name);
+    }
+
+    const SchemaSnapshot::MethodRecord *SchemaSnapshot::method(const TypeRecord &type, std::string_view name) const noexcept
+    {
+        return named(methods(type), name);
+    }
+
+    const SchemaSnapshot::PropertyRecord *SchemaSnapshot::property(const TypeRecord &type, std::string_view name) const noexcept
+    {
+        return named(properties(type), name);
+    }
+
+    const SchemaSnapshot::EventRecord *SchemaSnapshot::event(const TypeRecord &type, std::string_view name) const noexcept
+    {
+        return named(events(type), name);
+    }
+
+    bool SchemaSnapshot::compatible(const MetaObject &metaObject) const noexcept
+    {
+        const auto *type = find(metaObject.name());
+        if (!type || type->fingerprint != fingerprint(metaObject.type()))
+            return false;
+
+        auto matches = [](std::span<const TypeReference> recorded, const std::vector<std::type_index> &types) {
+            return std::ranges::equal(recorded, types, {}, &TypeReference::fingerprint, &SchemaSnapshot::fingerprint);
+        };
+
+        const auto liveBases = metaObject.bases();
+        for (const auto &base : bases(*type))
+            if (std::ranges::none_of(liveBases, [&base](const MetaObject *live) { return fingerprint(live->type()) == base.fingerprint; }))
+                return false;
+
+        for (const auto &constructor : constructors(*type))
+            if (!metaObject.hasConstructor(constructor.signature) || !matches(arguments(constructor), metaObject.constructor(constructor.signature).argumentTypes()))
+                return false;
+
+        for (const auto &method : methods(*type))
+        {
+            const auto name = string(method.name);
+            if (!metaObject.hasMethod(name))
+                return false;
+
+            const auto &live = metaObject.method(name);
+            for (const auto &overload : overloads(method))
+            {
+                const auto qualifier = static_cast<Method::Qualifier>(overload.qualifier);
+                if (!live.hasOverload(overload.signature, qualifier))
+                    return false;
+
+                const auto &resolved = live.overload(overload.signature, qualifier);
+                if (fingerprint(resolved.returnType()) != overload.returnType.fingerprint || !matches(arguments(overload), resolved.argumentTypes()))
+                    return false;
+            }
+        }
+
+        for (const auto &property : properties(*type))
+        {
+            const auto name = string(property.name);
+            if (!metaObject.hasProperty(name) || fingerprint(metaObject.property(name).type()) != property.type.fingerprint)
+                return false;
+        }
+
+        for (const auto &event : events(*type))
+        {
+            const auto name = string(event.name);
+            if (!metaObject.hasEvent(name) || metaObject.event(name).hash() != event.signature || !matches(arguments(event), metaObject.event(name).argumentTypes()))
+                return false;
+        }
+
+        return true;
+    }
+
+    std::vector<std::byte> Library::snapshot() const
+    {
+        return SchemaSnapshot::build(metaObjects());
+    }
+
+    void Library::snapshot(const std::string &path) const
+    {
+        const auto image = snapshot();
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(image.data()), static_cast<std::streamsize>(image.size()));
+
+        if (!out)
+            throw reflection_error("cannot write snapshot to " + path);
+    }
+}
@@ -0,0 +1,106 @@
+#include "reflection/symbol.h"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace lh::reflection
+{
+    namespace
+    {
+        // Open addressing table of entries, at most half full. Slots only ever go from empty to an entry, so
+        // lookups can probe it without locking while interning fills it.
+        struct SymbolSlots
+        {
+            explicit SymbolSlots(std::size_t capacity) :
+                mask(capacity - 1),
+                slots(std::make_unique<std::atomic<const Symbol::Entry *>[]>(capacity))
+            {
+            }
+
+            std::size_t capacity() const noexcept { return mask + 1; }
+
+            const Symbol::Entry *find(std::string_view name, std::size_t hash) const noexcept
+            {
+                for (auto i = hash & mask;; i = (i + 1) & mask)
+                {
+                    const auto *entry = slots[i].load(std::memory_order_acquire);
+                    if (!entry || (entry->hash == hash && entry->name == name))
+                        return entry;
+                }
+            }
+
+            void insert(const Symbol::Entry &entry) noexcept
+            {
+                auto i = entry.hash & mask;
+                while (slots[i].load(std::memory_order_relaxed))
+                    i = (i + 1) & mask;
+                slots[i].store(&entry, std::memory_order_release);
+            }
+
+            std::size_t mask;
+            std::unique_ptr<std::atomic<const Symbol::Entry *>[]> slots;
+        };
+
+        struct SymbolTable
+        {
+            std::mutex mutex; // serializes interning, lookups don't lock
+            std::deque<Symbol::Entry> entries; // deque keeps entries at stable addresses
+            std::vector<std::unique_ptr<SymbolSlots>> generations; // outgrown tables may still be probed
+            std::atomic<const SymbolSlots *> slots;
+
+            SymbolTable() :
+                generations(1)
+            {
+                generations.back() = std::make_unique<SymbolSlots>(256);
+                slots.store(generations.back().get(), std::memory_order_release);
+            }
+
+            static SymbolTable &instance() noexcept
+            {
+                static SymbolTable table;
+                return table;
+            }
+        };
+    }
+
+    Symbol Symbol::intern(std::string_view name)
+    {
+        auto &table = SymbolTable::instance();
+        const auto hash = std::hash<std::string_view>{}(name);
+
+        if (auto entry = table.slots.load(std::memory_order_acquire)->find(name, hash))
+            return Symbol(entry);
+
+        std::lock_guard lock(table.mutex);
+        auto *slots = table.generations.back().get();
+        if (auto entry = slots->find(name, hash))
+            return Symbol(entry);
+
+        // Id 0 is reserved for the empty symbol
+        const auto id = static_cast<std::uint32_t>(table.entries.size() + 1);
+        const auto &entry = table.entries.emplace_back(Entry{std::string(name), hash, id});
+
+        // Grown tables are filled before they are published
+        if (table.entries.size() * 2 > slots->capacity())
+        {
+            table.generations.push_back(std::make_unique<SymbolSlots>(slots->capacity() * 2));
+            slots = table.generations.back().get();
+            for (const auto &interned : table.entries)
+                slots->insert(interned);
+            table.slots.store(slots, std::memory_order_release);
+        }
+        else
+            slots->insert(entry);
+
+        return Symbol(&entry);
+    }
+
+    Symbol Symbol::find(std::string_view name) noexcept
+    {
+        const auto hash = std::hash<std::string_view>{}(name);
+        return Symbol(SymbolTable::instance().slots.load(std::memory_order_acquire)->find(name, hash));
+    }
+}
@@ -0,0 +1,170 @@
+#include "reflection/thread_pool.h"
+
+#include <limits>
+#include <utility>
+
+namespace lh::reflection
+{
+    namespace
+    {
+        // Pool whose loop the current thread is running, to run nested loops inline instead of deadlocking
+        thread_local const ThreadPool *current = nullptr;
+
+        constexpr std::uint64_t pack(std::uint64_t begin, std::uint64_t end) noexcept
+        {
+            return end << 32 | begin;
+        }
+
+        constexpr std::uint64_t begin(std::uint64_t bounds) noexcept { return bounds & 0xffffffff; }
+        constexpr std::uint64_t end(std::uint64_t bounds) noexcept { return bounds >> 32; }
+    }
+
+    ThreadPool::ThreadPool(std::size_t workers) :
+        _ranges(std::make_unique<Range[]>(workers + 1))
+    {
+        _workers.reserve(workers);
+        for (std::size_t i = 0; i < workers; ++i)
+            _workers.emplace_back(&ThreadPool::work, this, i + 1);
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        _stopping = true;
+        _generation.fetch_add(1, std::memory_order_release);
+        _generation.notify_all();
+
+        for (auto &worker : _workers)
+            worker.join();
+    }
+
+    ThreadPool &ThreadPool::shared()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    void ThreadPool::run(std::size_t count, std::size_t grain, task_t task, const void *context)
+    {
+        if (!count)
+            return;
+
+        // Chunk indices have to fit into half of a range
+        grain = std::max({grain, std::size_t(1), count / std::numeric_limits<std::uint32_t>::max() + 1});
+        const auto chunks = (count + grain - 1) / grain;
+
+        std::unique_lock lock(_submit, std::try_to_lock);
+        if (!lock || current == this || _workers.empty() || chunks == 1)
+        {
+            task(context, 0, count);
+            return;
+        }
+
+        _task = task;
+        _context = context;
+        _count = count;
+        _grain = grain;
+        _error = nullptr;
+        _failed.store(false, std::memory_order_relaxed);
+
+        const auto threads = _workers.size() + 1;
+        for (std::size_t i = 0; i < threads; ++i)
+            _ranges[i].bounds.store(pack(chunks * i / threads, chunks * (i + 1) / threads), std::memory_order_relaxed);
+
+        _active.store(threads, std::memory_order_relaxed);
+        _generation.fetch_add(1, std::memory_order_release);
+        _generation.notify_all();
+
+        current = this;
+        participate(0);
+        current = nullptr;
+
+        while (auto active = _active.load(std::memory_order_acquire))
+            _active.wait(active, std::memory_order_acquire);
+
+        if (_error)
+            std::rethrow_exception(std::exchange(_error, nullptr));
+    }
+
+    void ThreadPool::work(std::size_t index)
+    {
+        current = this;
+
+        for (std::uint32_t seen = 0;;)
+        {
+            _generation.wait(seen, std::memory_order_acquire);
+            seen = _generation.load(std::memory_order_acquire);
+
+            if (_stopping)
+                return;
+
+            participate(index);
+        }
+    }
+
+    void ThreadPool::participate(std::size_t index) noexcept
+    {
+        auto &range = _ranges[index].bounds;
+
+        do
+        {
+            // Only the owner takes from the front, thieves take from the back
+            auto bounds = range.load(std::memory_order_acquire);
+            while (begin(bounds) < end(bounds))
+            {
+                if (range.compare_exchange_weak(bounds, pack(begin(bounds) + 1, end(bounds)), std::memory_order_acq_rel))
+                {
+                    execute(begin(bounds));
+                    bounds = range.load(std::memory_order_acquire);
+                }
+            }
+        } while (steal(index));
+
+        if (_active.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            _active.notify_all();
+    }
+
+    bool ThreadPool::steal(std::size_t thief) noexcept
+    {
+        const auto threads = _workers.size() + 1;
+
+        for (std::size_t i = 1; i < threads; ++i)
+        {
+            auto &victim = _ranges[(thief + i) % threads].bounds;
+            auto bounds = victim.load(std::memory_order_acquire);
+
+            while (begin(bounds) < end(bounds))
+            {
+                const auto split = end(bounds) - (end(bounds) - begin(bounds) + 1) / 2;
+                if (victim.compare_exchange_weak(bounds, pack(begin(bounds), split), std::memory_order_acq_rel))
+                {
+                    // The own range is empty, so no one else can be changing it
+                    _ranges[thief].bounds.store(pack(split, end(bounds)), std::memory_order_release);
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    void ThreadPool::execute(std::uint64_t chunk) noexcept
+    {
+        if (_failed.load(std::memory_order_relaxed))
+            return;
+
+        const auto first = static_cast<std::size_t>(chunk) * _grain;
+
+        try
+        {
+            _task(_context, first, std::min(first + _grain, _count));
+        }
+        catch (...)
+        {
+            std::lock_guard lock(_errorMutex);
+            if (!_error)
+                _error = std::current_exception();
+
+            _failed.store(true, std::memory_order_relaxed);
+        }
+    }
+}
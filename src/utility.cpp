@@ -12,17 +12,4 @@ namespace lh::reflection::utility
         return join(names, ", ");
     }
 
-    std::size_t signatureHash(const std::vector<std::type_index> &arguments) noexcept
-    {
-        if (arguments.size() == 0)
-            return 0;
-
-        auto currentArgument = arguments.begin();
-
-        size_t hash = (currentArgument++)->hash_code();
-        for (; currentArgument < arguments.end(); ++currentArgument)
-            hash ^= currentArgument->hash_code() + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-
-        return hash;
-    }
 }
\ No newline at end of file
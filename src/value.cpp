@@ -0,0 +1,47 @@
+#include "reflection/value.h"
+
+#include <memory>
+#include <algorithm>
+
+namespace lh::reflection
+{
+    namespace
+    {
+        struct FrameStack
+        {
+            utility::arena arena{16 * 1024};
+            std::size_t depth = 0;
+        };
+
+        thread_local FrameStack frames;
+    }
+
+    std::string Value::signatureString(std::span<const Value> values)
+    {
+        std::vector<std::type_index> types;
+        types.reserve(values.size());
+        std::ranges::transform(values, std::back_inserter(types), [](const auto &value) { return value.type(); });
+
+        return utility::signatureString(types);
+    }
+
+    ArgumentFrame::ArgumentFrame(std::size_t size) :
+        _marker(frames.arena.mark()),
+        _values(static_cast<Value *>(frames.arena.allocate(size * sizeof(Value), alignof(Value)))),
+        _size(size)
+    {
+        std::uninitialized_default_construct_n(_values, _size);
+        ++frames.depth;
+    }
+
+    ArgumentFrame::~ArgumentFrame()
+    {
+        std::destroy_n(_values, _size);
+
+        // The outermost frame gives everything back, which also drops blocks a deep nesting has grown
+        if (--frames.depth == 0)
+            frames.arena.release();
+        else
+            frames.arena.rewind(_marker);
+    }
+}
@@ -1,9 +1,57 @@
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
 #include <reflection/reflectable.h>
+#include <reflection/library.h>
+#include <reflection/perfect_hash.h>
+#include <reflection/event_bus.h>
+#include <reflection/serializer.h>
+#include <reflection/json.h>
+#include <reflection/snapshot.h>
+#include <reflection/pool.h>
+#include <reflection/value.h>
+#include <reflection/declaration.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <deque>
+#include <fstream>
+#include <filesystem>
+#include <memory_resource>
+#include <numeric>
 
 using namespace lh::reflection;
 
+namespace
+{
+    struct Counter : public Reflectable
+    {
+        int count = 0;
+
+        void add(int value) { count += value; }
+        int get() const { return count; }
+    };
+
+    int twice(int value)
+    {
+        return 2 * value;
+    }
+
+    // Copies throw once the given number of copies has been made
+    struct Fragile
+    {
+        static inline int copies = 0;
+
+        Fragile() = default;
+        Fragile(const Fragile &)
+        {
+            if (copies-- <= 0)
+                throw std::runtime_error("copy failed");
+        }
+    };
+}
+
 TEST_CASE("Default Construct")
 {
     Reflectable testee;
@@ -74,3 +122,2201 @@ TEST_CASE("MetaObject Methods")
     REQUIRE(meta.methods().size() == 1);
     REQUIRE_NOTHROW(meta.method("check"));
 }
+
+TEST_CASE("MetaObject Handles")
+{
+    MetaObject meta("Reflectable", typeid(Reflectable));
+    Reflectable testee;
+
+    int count = 0;
+
+    meta.addMethod("increment", std::function([&count](Reflectable*, int value) -> void {
+        count += value;
+    }), Method::Qualifier::Mutable);
+
+    meta.addMethod("compare", std::function([&count](Reflectable*, int value) -> bool {
+        return count == value;
+    }), Method::Qualifier::Immutable);
+
+    meta.addMethod("twice", std::function([](int value) -> int {
+        return 2 * value;
+    }));
+
+    meta.addProperty("count",
+        std::function([&count](const Reflectable*) -> int {
+            return count;
+        }),
+        std::function([&count](Reflectable*, int value) -> void {
+            count = value;
+        })
+    );
+
+    STATIC_REQUIRE(std::is_trivially_copyable_v<MethodHandle<void, int>>);
+    STATIC_REQUIRE(std::is_trivially_copyable_v<PropertyHandle<int>>);
+
+    auto increment = meta.methodHandle<void, int>("increment", Method::Qualifier::Mutable);
+    auto compare = meta.methodHandle<bool, int>("compare", Method::Qualifier::Mutable);
+    auto twice = meta.methodHandle<int, int>("twice");
+    auto property = meta.propertyHandle<int>("count");
+
+    REQUIRE(increment);
+    REQUIRE_FALSE(MethodHandle<void, int>());
+
+    increment.invoke(&testee, 5);
+    REQUIRE(count == 5);
+    REQUIRE(compare.invoke(&testee, 5));
+    REQUIRE(twice.invoke(21) == 42);
+
+    // Handles keep the qualifier they were resolved for
+    const Reflectable &constant = testee;
+    REQUIRE(meta.methodHandle<bool, int>("compare", Method::Qualifier::Immutable).invoke(&constant, 5));
+    REQUIRE_THROWS_AS(increment.invoke(&constant, 1), invalid_method_type);
+    REQUIRE_THROWS_AS(increment.invoke(1), invalid_method_type);
+    REQUIRE_THROWS_AS(compare.invoke(5), invalid_method_type);
+    REQUIRE(count == 5);
+
+    property.set(&testee, 42);
+    REQUIRE(property.get(&testee) == 42);
+
+    REQUIRE_THROWS_AS((meta.methodHandle<bool, int>("increment", Method::Qualifier::Mutable)), invalid_method_type);
+    REQUIRE_THROWS_AS((meta.methodHandle<void, std::string>("increment", Method::Qualifier::Mutable)), unknown_method);
+    REQUIRE_THROWS_AS((meta.methodHandle<void, int>("compare", Method::Qualifier::Static)), unknown_method);
+    REQUIRE_THROWS_AS(meta.propertyHandle<double>("count"), invalid_property_type);
+}
+
+TEST_CASE("Symbol Lookup")
+{
+    auto symbol = Symbol::intern("symbol_lookup");
+
+    REQUIRE(symbol);
+    REQUIRE(symbol == Symbol::intern(std::string("symbol_lookup")));
+    REQUIRE(symbol == Symbol::find("symbol_lookup"));
+    REQUIRE(symbol.name() == "symbol_lookup");
+    REQUIRE(symbol.hash() == std::hash<std::string_view>{}("symbol_lookup"));
+    REQUIRE_FALSE(Symbol::find("symbol_lookup_never_interned"));
+
+    MetaObject meta("Reflectable", typeid(Reflectable));
+
+    meta.addMethod("symbol_lookup", std::function([](int value) -> int {
+        return value;
+    }));
+
+    REQUIRE(meta.hasMethod(symbol));
+    REQUIRE(meta.hasMethod(std::string_view("symbol_lookup")));
+    REQUIRE(&meta.method(symbol) == &meta.method("symbol_lookup"));
+    REQUIRE_FALSE(meta.hasProperty(symbol));
+    REQUIRE_THROWS_AS(meta.method("symbol_lookup_never_interned"), unknown_method);
+}
+
+TEST_CASE("Compile-Time Type Identifiers")
+{
+    STATIC_REQUIRE(utility::typeId<int>() == utility::typeId<int>());
+    STATIC_REQUIRE(utility::typeId<int>() != utility::typeId<long>());
+    STATIC_REQUIRE(utility::typeId<int>() != utility::typeId<const int &>());
+    STATIC_REQUIRE(utility::signatureHash<>() == 0);
+    STATIC_REQUIRE(utility::signatureHash<int, double>() != utility::signatureHash<double, int>());
+
+    MetaObject meta("Reflectable", typeid(Reflectable));
+
+    meta.addMethod("signature", std::function([](int value, double factor) -> double {
+        return value * factor;
+    }));
+
+    REQUIRE(meta.method("signature").invoke<double>(2, 1.5) == 3.0);
+    REQUIRE_THROWS_AS(meta.method("signature").invoke<int>(2, 1.5), invalid_method_type);
+    REQUIRE_THROWS_AS(meta.method("signature").invoke<double>(1.5, 2), unknown_method);
+}
+
+TEST_CASE("Inline Function Storage")
+{
+    Counter counter;
+    auto shared = std::make_shared<int>(42);
+
+    {
+        MetaObject meta("Counter", typeid(Counter));
+
+        meta.addMethod("add", &Counter::add);
+        meta.addMethod("get", &Counter::get);
+        meta.addMethod("twice", &twice);
+
+        meta.addMethod("shared", [shared](Reflectable*) -> int {
+            return *shared;
+        }, Method::Qualifier::Immutable);
+
+        std::array<int, 64> large{};
+        large[63] = 7;
+
+        meta.addMethod("large", [large](int index) mutable -> int {
+            return large[index]++;
+        });
+
+        REQUIRE(shared.use_count() == 2);
+
+        meta.methodHandle<void, int>("add", Method::Qualifier::Mutable).invoke(&counter, 5);
+        REQUIRE(counter.count == 5);
+        REQUIRE(meta.methodHandle<int>("get", Method::Qualifier::Immutable).invoke(&counter) == 5);
+        REQUIRE(meta.method("twice").invoke<int>(21) == 42);
+        REQUIRE(meta.methodHandle<int>("shared", Method::Qualifier::Immutable).invoke(&counter) == 42);
+        REQUIRE(meta.method("large").invoke<int>(63) == 7);
+        REQUIRE(meta.method("large").invoke<int>(63) == 8);
+
+        meta.addEvent<int>("changed");
+
+        int received = 0;
+        auto subscription = meta.event("changed").subscribe([&received](int value) {
+            received = value;
+        });
+
+        meta.event("changed").invoke(subscription, 42);
+        REQUIRE(received == 42);
+        REQUIRE_THROWS_AS(meta.event("changed").subscribe([](double) {}), invalid_event_type);
+    }
+
+    REQUIRE(shared.use_count() == 1);
+}
+
+TEST_CASE("Throwing Registration")
+{
+    // Callables that may throw on a move are stored in a std::function, any copy on the way there may fail
+    int failures = 0;
+    for (int copies = 0;; ++copies)
+    {
+        MetaObject meta("Fragile", typeid(Reflectable));
+        meta.addMethod("existing", &twice);
+
+        Fragile::copies = copies;
+        try
+        {
+            meta.addMethod("fragile", [fragile = Fragile()](Reflectable*, int value) -> int {
+                return value;
+            }, Method::Qualifier::Mutable);
+        }
+        catch (const std::runtime_error &)
+        {
+            ++failures;
+            REQUIRE_FALSE(meta.hasMethod("fragile"));
+            REQUIRE(meta.methods().size() == 1);
+            continue;
+        }
+
+        REQUIRE(meta.hasMethod("fragile"));
+        break;
+    }
+
+    REQUIRE(failures > 3);
+}
+
+TEST_CASE("MetaObject Sealing")
+{
+    MetaObject meta("Counter", typeid(Counter));
+    Counter counter;
+
+    meta.addMethod("add", &Counter::add);
+    meta.addMethod("get", &Counter::get);
+    meta.addMethod("twice", &twice);
+    meta.addMethod("twice", [](int value, int factor) -> int { return value * factor; });
+    meta.addProperty("count",
+        [](const Counter *instance) -> int { return instance->count; },
+        [](Counter *instance, int value) { instance->count = value; });
+    meta.addEvent<int>("changed");
+
+    REQUIRE_FALSE(meta.sealed());
+    meta.seal();
+    REQUIRE(meta.sealed());
+    REQUIRE(meta.method("twice").sealed());
+
+    REQUIRE(meta.methods().size() == 3);
+    REQUIRE(meta.method("twice").overloads().size() == 2);
+    REQUIRE(meta.hasMethod("add"));
+    REQUIRE(meta.hasProperty("count"));
+    REQUIRE(meta.hasEvent("changed"));
+    REQUIRE_FALSE(meta.hasMethod("count"));
+    REQUIRE_THROWS_AS(meta.method("count"), unknown_method);
+
+    meta.methodHandle<void, int>("add", Method::Qualifier::Mutable).invoke(&counter, 5);
+    REQUIRE(meta.property("count").get<Counter, int>(&counter) == 5);
+    REQUIRE(meta.method("twice").invoke<int>(21) == 42);
+    REQUIRE(meta.method("twice").invoke<int>(21, 3) == 63);
+
+    REQUIRE_THROWS_AS(meta.addMethod("sub", &Counter::add), registration_failed);
+    REQUIRE_THROWS_AS(meta.addEvent<int>("reset"), registration_failed);
+    REQUIRE_THROWS_AS(meta.addConstructor([]() -> Counter * { return new Counter(); }), registration_failed);
+}
+
+TEST_CASE("Sealed Method Calls")
+{
+    Counter counter;
+    const Counter &constant = counter;
+
+    Method add("add");
+    add.addOverload(&Counter::add, std::type_identity<void(Counter *, int)>(), Method::Qualifier::Mutable);
+
+    Method get("get");
+    get.addOverload(&Counter::get, std::type_identity<int(const Counter *)>(), Method::Qualifier::Immutable);
+
+    Method scale("scale");
+    scale.addOverload(&twice, std::type_identity<int(int)>());
+    scale.addOverload([](const int &value, int factor) -> int { return value * factor; }, std::type_identity<int(const int &, int)>());
+
+    const auto unsealed = add.memoryUsage().overloads;
+    add.seal();
+    get.seal();
+    scale.seal();
+    REQUIRE(add.memoryUsage().overloads > 0);
+    REQUIRE(add.memoryUsage().overloads != unsealed);
+
+    add.invoke<void, Counter, int>(&counter, 5, Method::Qualifier::Mutable);
+    REQUIRE(counter.count == 5);
+
+    // const methods can still be called on non-const objects
+    REQUIRE(get.invoke<int>(&counter, Method::Qualifier::Mutable) == 5);
+    REQUIRE(get.invoke<int>(&constant, Method::Qualifier::Immutable) == 5);
+    REQUIRE_THROWS_AS((add.invoke<void, const Counter, int>(&constant, 1, Method::Qualifier::Immutable)), unknown_method);
+
+    REQUIRE(scale.invoke<int>(21) == 42);
+    REQUIRE(scale.invoke<int>(21, 3) == 63);
+    REQUIRE_THROWS_AS(scale.invoke<double>(21), invalid_method_type);
+    REQUIRE_THROWS_AS(get.invoke<void>(&counter, Method::Qualifier::Mutable), invalid_method_type);
+
+    // Moving the method keeps its records valid
+    Method moved(std::move(scale));
+    REQUIRE(moved.invoke<int>(8) == 16);
+    REQUIRE(moved.invoke<int>(4, 4) == 16);
+}
+
+TEST_CASE("Perfect Hash")
+{
+    std::vector<std::uint64_t> hashes;
+    for (int i = 0; i < 10000; ++i)
+        hashes.push_back(std::hash<std::string>{}("key" + std::to_string(i)));
+
+    utility::perfect_hash index(hashes);
+    std::vector<bool> used(index.slots(), false);
+
+    for (auto hash : hashes)
+    {
+        const auto slot = index.slot(hash);
+        REQUIRE(slot < index.slots());
+        REQUIRE_FALSE(used[slot]);
+        used[slot] = true;
+    }
+}
+
+TEST_CASE("Library Finalization")
+{
+    // Registers with the library of its own thread, which must not outlive the MetaObjects
+    std::thread([] {
+        auto &library = Library::thread();
+
+        // An empty library has nothing to index, lookups still have to miss
+        library.finalize();
+        REQUIRE(library.finalized());
+        REQUIRE_FALSE(library.exists("FinalizedTypeMissing"));
+        REQUIRE(library.findMetaObject(Symbol::intern("FinalizedTypeMissing")) == nullptr);
+    }).join();
+
+    std::thread([] {
+        auto &library = Library::thread();
+
+        std::vector<std::unique_ptr<MetaObject>> types;
+        for (int i = 0; i < 100; ++i)
+        {
+            types.push_back(std::make_unique<MetaObject>("FinalizedType" + std::to_string(i), typeid(Reflectable)));
+            library.add(types.back().get());
+        }
+
+        REQUIRE_FALSE(library.finalized());
+        library.finalize();
+        REQUIRE(library.finalized());
+
+        for (const auto &type : types)
+        {
+            REQUIRE(&library.metaObject(type->name()) == type.get());
+            REQUIRE(&library.metaObject(Symbol::find(type->name())) == type.get());
+        }
+
+        MetaObject late("FinalizedTypeLate", typeid(Reflectable));
+        library.add(&late);
+
+        REQUIRE(&library.metaObject("FinalizedTypeLate") == &late);
+        REQUIRE(library.exists("FinalizedType42"));
+        REQUIRE_FALSE(library.exists("FinalizedTypeMissing"));
+        REQUIRE_THROWS_AS(library.metaObject("FinalizedTypeMissing"), unknown_type);
+        REQUIRE_THROWS_AS(library.add(types.front().get()), registration_failed);
+    }).join();
+}
+
+TEST_CASE("Library Concurrent Lookup")
+{
+    auto &library = Library::global();
+
+    static std::deque<MetaObject> initial;
+    for (int i = 0; i < 64; ++i)
+        library.add(&initial.emplace_back("ConcurrentType" + std::to_string(i), typeid(Reflectable)));
+
+    static std::deque<MetaObject> added;
+    std::atomic<bool> done = false;
+    std::atomic<int> failures = 0;
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t)
+    {
+        readers.emplace_back([&] {
+            while (!done)
+            {
+                for (const auto &type : initial)
+                    if (&library.metaObject(type.name()) != &type)
+                        ++failures;
+
+                if (library.exists("ConcurrentTypeMissing"))
+                    ++failures;
+            }
+        });
+    }
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        library.add(&added.emplace_back("ConcurrentAdded" + std::to_string(i), typeid(Reflectable)));
+        if (i == 1000)
+            library.finalize();
+    }
+
+    done = true;
+    for (auto &reader : readers)
+        reader.join();
+
+    REQUIRE(failures == 0);
+    for (const auto &type : added)
+        REQUIRE(&library.metaObject(type.name()) == &type);
+}
+
+TEST_CASE("Asynchronous Events")
+{
+    auto &mo = const_cast<MetaObject &>(Reflectable::staticMetaObject());
+    if (!mo.hasEvent("queued"))
+        mo.addEvent<int>("queued");
+
+    SECTION("Ordered Delivery")
+    {
+        EventBus bus(2);
+        Reflectable emitter;
+        emitter.setEventBus(&bus);
+
+        std::vector<int> received;
+        std::thread::id handlerThread;
+        emitter.subscribe("queued", [&](int value) {
+            handlerThread = std::this_thread::get_id();
+            received.push_back(value);
+        });
+
+        for (int i = 0; i < 1000; ++i)
+            emitter.event("queued", i);
+
+        bus.flush();
+
+        REQUIRE(received.size() == 1000);
+        for (int i = 0; i < 1000; ++i)
+            REQUIRE(received[i] == i);
+
+        REQUIRE(handlerThread != std::this_thread::get_id());
+        REQUIRE_THROWS_AS(emitter.event("queued", 1.0), invalid_event_type);
+    }
+
+    SECTION("Unsubscribing")
+    {
+        EventBus bus(1);
+        Reflectable emitter;
+        emitter.setEventBus(&bus);
+
+        std::atomic<bool> started = false;
+        std::atomic<bool> release = false;
+        std::vector<int> received;
+        emitter.subscribe("queued", [&](int) {
+            started = true;
+            while (!release)
+                std::this_thread::yield();
+        });
+        emitter.subscribe("queued", [&received](int value) { received.push_back(value); });
+
+        emitter.event("queued", 7);
+        while (!started)
+            std::this_thread::yield();
+
+        // Queued deliveries keep their handlers, while the subscriptions are dropped and reallocated
+        emitter.unsubscribe();
+        for (int i = 0; i < 100; ++i)
+            emitter.subscribe("queued", [](int) {});
+
+        release = true;
+        bus.flush();
+        REQUIRE(received == std::vector<int>{7});
+    }
+
+    SECTION("Backpressure")
+    {
+        const auto overflow = GENERATE(EventBus::Overflow::DropNewest, EventBus::Overflow::DropOldest);
+
+        EventBus bus(1, 4, overflow);
+        Reflectable emitter;
+        emitter.setEventBus(&bus);
+
+        std::atomic<bool> started = false;
+        std::atomic<bool> release = false;
+        std::vector<int> received;
+
+        emitter.subscribe("queued", [&](int value) {
+            started = true;
+            while (!release)
+                std::this_thread::yield();
+
+            received.push_back(value);
+        });
+
+        emitter.event("queued", 0);
+        while (!started)
+            std::this_thread::yield();
+
+        for (int i = 1; i <= 10; ++i)
+            emitter.event("queued", i);
+
+        release = true;
+        bus.flush();
+
+        REQUIRE(bus.dropped() == 6);
+        if (overflow == EventBus::Overflow::DropNewest)
+            REQUIRE(received == std::vector<int>{0, 1, 2, 3, 4});
+        else
+            REQUIRE(received == std::vector<int>{0, 7, 8, 9, 10});
+    }
+
+    SECTION("Throwing Handlers")
+    {
+        EventBus bus(1);
+        Reflectable emitter;
+        emitter.setEventBus(&bus);
+
+        std::vector<int> received;
+        emitter.subscribe("queued", [&received](int value) {
+            if (value % 2)
+                throw std::runtime_error("odd value");
+
+            received.push_back(value);
+        });
+
+        for (int i = 0; i < 6; ++i)
+            emitter.event("queued", i);
+
+        // A throwing handler neither ends the worker nor keeps it from reaching the barrier
+        bus.flush();
+        REQUIRE(bus.failed() == 3);
+        REQUIRE(received == std::vector<int>{0, 2, 4});
+
+        emitter.event("queued", 6);
+        bus.flush();
+        REQUIRE(received == std::vector<int>{0, 2, 4, 6});
+    }
+}
+
+TEST_CASE("Event Handles")
+{
+    MetaObject meta("EventHandleType", typeid(Reflectable));
+    meta.addEvent<int>("first");
+    meta.addEvent<int, int>("second");
+    meta.addEvent<>("third");
+
+    REQUIRE(meta.event("first").ordinal() == 0);
+    REQUIRE(meta.event("second").ordinal() == 1);
+    REQUIRE(meta.event("third").ordinal() == 2);
+
+    struct Emitter : Reflectable
+    {
+        const MetaObject *meta;
+        const MetaObject &metaObject() const noexcept override { return *meta; }
+    };
+
+    Emitter emitter;
+    emitter.meta = &meta;
+
+    int sum = 0;
+    emitter.subscribe("second", [&sum](int a, int b) { sum += a * b; });
+    emitter.subscribe("second", [&sum](int a, int b) { sum += a + b; });
+
+    auto second = meta.eventHandle<int, int>("second");
+    REQUIRE(second);
+    REQUIRE(second.ordinal() == 1);
+
+    emitter.event(second, 3, 4);
+    REQUIRE(sum == 19);
+
+    // Nobody subscribed to these, emitting is a no-op
+    emitter.event(meta.eventHandle<int>("first"), 1);
+    emitter.event(meta.eventHandle<>("third"));
+    REQUIRE(sum == 19);
+
+    REQUIRE_THROWS_AS(meta.eventHandle<double>("first"), invalid_event_type);
+
+    // Subscriptions are kept by ordinal and survive sealing
+    meta.seal();
+    emitter.event("second", 1, 1);
+    REQUIRE(sum == 22);
+}
+
+TEST_CASE("Property Columns")
+{
+    MetaObject meta("ColumnType", typeid(Reflectable));
+    meta.addProperty("count",
+        [](const Counter *counter) -> int { return counter->count; },
+        [](Counter *counter, int value) { counter->count = value; });
+
+    const auto &property = meta.property("count");
+
+    std::vector<Counter> counters(100);
+    for (int i = 0; i < 100; ++i)
+        counters[i].count = i;
+
+    std::vector<const Counter *> pointers;
+    for (const auto &counter : counters)
+        pointers.push_back(&counter);
+
+    std::vector<int> column(100);
+    property.gather<Counter, int>(pointers, column);
+    for (int i = 0; i < 100; ++i)
+        REQUIRE(column[i] == i);
+
+    std::ranges::for_each(column, [](int &value) { value *= 2; });
+    property.scatter<Counter, int>(counters, column);
+    for (int i = 0; i < 100; ++i)
+        REQUIRE(counters[i].count == 2 * i);
+
+    std::vector<int> contiguous(100);
+    property.gather<Counter, int>(std::span<const Counter>(counters), contiguous);
+    REQUIRE(contiguous == column);
+
+    std::vector<Counter *> mutablePointers;
+    for (auto &counter : counters)
+        mutablePointers.push_back(&counter);
+
+    const std::vector<int> zeros(100, 0);
+    property.scatter<Counter, int>(mutablePointers, zeros);
+    REQUIRE(std::ranges::all_of(counters, [](const Counter &counter) { return counter.count == 0; }));
+
+    std::vector<double> wrongType(100);
+    std::vector<int> tooShort(10);
+    REQUIRE_THROWS_AS((property.gather<Counter, double>(pointers, wrongType)), invalid_property_type);
+    REQUIRE_THROWS_AS((property.gather<Counter, int>(pointers, tooShort)), reflection_error);
+}
+
+TEST_CASE("Binary Serialization")
+{
+    struct Record
+    {
+        std::int32_t id = 0;
+        double value = 0;
+        bool flag = false;
+        std::string label;
+    };
+
+    MetaObject meta("SerializedRecord", typeid(Record));
+    meta.addProperty("id", [](const Record *r) { return r->id; }, [](Record *r, std::int32_t v) { r->id = v; });
+    meta.addProperty("value", [](const Record *r) { return r->value; }, [](Record *r, double v) { r->value = v; });
+    meta.addProperty("flag", [](const Record *r) { return r->flag; }, [](Record *r, bool v) { r->flag = v; });
+
+    SECTION("Fixed Size")
+    {
+        Serializer serializer(meta);
+        REQUIRE(serializer.fields() == 3);
+        REQUIRE(serializer.fixedSize() == sizeof(std::int32_t) + sizeof(double) + 1);
+
+        Record in{7, 2.5, true, {}};
+        std::array<std::byte, 64> buffer;
+        REQUIRE(serializer.encode(&in, std::span(buffer)) == serializer.fixedSize());
+
+        // Fields are ordered by name: flag, id, value
+        REQUIRE(buffer[0] == std::byte(1));
+        REQUIRE(buffer[1] == std::byte(7));
+
+        Record out;
+        REQUIRE(serializer.decode(&out, std::span<const std::byte>(buffer)) == serializer.fixedSize());
+        REQUIRE(out.id == 7);
+        REQUIRE(out.value == 2.5);
+        REQUIRE(out.flag);
+
+        REQUIRE_THROWS_AS(serializer.encode(&in, std::span(buffer).first(4)), serialization_failed);
+        REQUIRE_THROWS_AS(serializer.decode(&out, std::span<const std::byte>(buffer).first(4)), serialization_failed);
+
+        // Bulk encoding of fixed size records writes one property at a time, the output is the same
+        std::vector<Record> records;
+        for (int i = 0; i < 10; ++i)
+            records.push_back(Record{i, i * 1.5, i % 3 == 0, {}});
+
+        std::vector<std::byte> stream;
+        serializer.encode(std::span<const Record>(records), std::span(buffer), [&](std::span<const std::byte> part) {
+            stream.insert(stream.end(), part.begin(), part.end());
+        });
+
+        REQUIRE(stream.size() == records.size() * serializer.fixedSize());
+        for (std::size_t i = 0; i < records.size(); ++i)
+        {
+            std::array<std::byte, 64> single;
+            serializer.encode(&records[i], std::span(single));
+            REQUIRE(std::equal(single.begin(), single.begin() + serializer.fixedSize(), stream.begin() + i * serializer.fixedSize()));
+        }
+    }
+
+    SECTION("Streaming")
+    {
+        meta.addProperty("label", [](const Record *r) { return r->label; }, [](Record *r, std::string v) { r->label = std::move(v); });
+
+        Serializer serializer(meta);
+        REQUIRE(serializer.fixedSize() == 0);
+
+        std::vector<Record> records;
+        for (int i = 0; i < 100; ++i)
+            records.push_back(Record{i, i * 0.5, i % 2 == 0, "record " + std::to_string(i)});
+
+        std::array<std::byte, 100> buffer;
+        std::vector<std::byte> stream;
+        int flushes = 0;
+
+        const auto total = serializer.encode(std::span<const Record>(records), std::span(buffer), [&](std::span<const std::byte> part) {
+            stream.insert(stream.end(), part.begin(), part.end());
+            ++flushes;
+        });
+
+        REQUIRE(total == stream.size());
+        REQUIRE(flushes > 1);
+
+        std::span<const std::byte> input(stream);
+        for (const auto &expected : records)
+        {
+            Record decoded;
+            input = input.subspan(serializer.decode(&decoded, input));
+
+            REQUIRE(decoded.id == expected.id);
+            REQUIRE(decoded.value == expected.value);
+            REQUIRE(decoded.flag == expected.flag);
+            REQUIRE(decoded.label == expected.label);
+        }
+
+        REQUIRE(input.empty());
+    }
+
+    SECTION("Unsupported Types")
+    {
+        meta.addProperty("items", [](const Record *) { return std::vector<int>(); }, [](Record *, std::vector<int>) {});
+        REQUIRE_THROWS_AS(Serializer(meta), serialization_failed);
+    }
+}
+
+TEST_CASE("JSON Codec")
+{
+    struct Config
+    {
+        std::int32_t port = 0;
+        double ratio = 0;
+        bool enabled = false;
+        std::string host;
+    };
+
+    MetaObject meta("JsonConfig", typeid(Config));
+    meta.addProperty("port", [](const Config *c) { return c->port; }, [](Config *c, std::int32_t v) { c->port = v; });
+    meta.addProperty("ratio", [](const Config *c) { return c->ratio; }, [](Config *c, double v) { c->ratio = v; });
+    meta.addProperty("enabled", [](const Config *c) { return c->enabled; }, [](Config *c, bool v) { c->enabled = v; });
+    meta.addProperty("host", [](const Config *c) { return c->host; }, [](Config *c, std::string v) { c->host = std::move(v); });
+
+    JsonCodec codec(meta);
+
+    SECTION("Read")
+    {
+        Config config;
+        const std::string_view json = R"(  {
+            "host": "example\n\"org\" \u00e9\ud83d\ude00",
+            "port": 8080, "unknown": {"nested": [1, 2, {"deep": null}], "text": "}"},
+            "ratio": -1.5e2,
+            "enabled": true,
+            "extra": null
+        })";
+
+        REQUIRE(codec.read(&config, json) == json.size());
+        REQUIRE(config.port == 8080);
+        REQUIRE(config.ratio == -150.0);
+        REQUIRE(config.enabled);
+        REQUIRE(config.host == "example\n\"org\" \xc3\xa9\xf0\x9f\x98\x80");
+
+        REQUIRE_THROWS_AS(codec.read(&config, R"({"port": 1.5})"), serialization_failed);
+        REQUIRE_THROWS_AS(codec.read(&config, R"({"port": 99999999999})"), serialization_failed);
+        REQUIRE_THROWS_AS(codec.read(&config, R"({"host": "unterminated)"), serialization_failed);
+        REQUIRE_THROWS_AS(codec.read(&config, R"({"port" 1})"), serialization_failed);
+    }
+
+    SECTION("Round Trip")
+    {
+        Config config{443, 0.25, true, "tab\there \"quoted\""};
+
+        const auto json = codec.write(&config);
+        REQUIRE(json == R"({"enabled":true,"host":"tab\there \"quoted\"","port":443,"ratio":0.25})");
+
+        Config copy;
+        codec.read(&copy, json);
+        REQUIRE(copy.port == config.port);
+        REQUIRE(copy.ratio == config.ratio);
+        REQUIRE(copy.enabled == config.enabled);
+        REQUIRE(copy.host == config.host);
+    }
+
+    SECTION("Streaming Arrays")
+    {
+        std::vector<Config> configs;
+        for (int i = 0; i < 50; ++i)
+            configs.push_back(Config{i, i / 4.0, i % 2 == 1, "host" + std::to_string(i)});
+
+        std::string json;
+        codec.writeArray(std::span<const Config>(configs), json);
+
+        std::vector<Config> read;
+        REQUIRE(codec.readArray<Config>(json, [&read](Config &&config) { read.push_back(std::move(config)); }) == 50);
+
+        REQUIRE(read.size() == 50);
+        for (int i = 0; i < 50; ++i)
+        {
+            REQUIRE(read[i].port == i);
+            REQUIRE(read[i].ratio == i / 4.0);
+            REQUIRE(read[i].host == configs[i].host);
+        }
+
+        REQUIRE(codec.readArray<Config>(" [ ] ", [](Config &&) {}) == 0);
+    }
+
+    SECTION("Copies")
+    {
+        // Copies look keys up in their own fields, and outlive the codec they were copied from
+        auto source = std::make_unique<JsonCodec>(meta);
+        const auto copy = *source;
+        source.reset();
+
+        Config config;
+        copy.read(&config, R"({"port": 22, "host": "copied"})");
+        REQUIRE(config.port == 22);
+        REQUIRE(config.host == "copied");
+    }
+}
+
+TEST_CASE("Schema Snapshot")
+{
+    struct Shape
+    {
+        int sides = 0;
+    };
+
+    MetaObject base("SnapshotBase", typeid(Reflectable));
+    MetaObject shape("SnapshotShape", typeid(Shape), {&base});
+    shape.addConstructor([](int sides) { return new Shape{sides}; });
+    shape.addMethod("area", [](Shape *s, double scale) -> double { return s->sides * scale; });
+    shape.addMethod("area", [](const Shape *s) -> double { return s->sides; }, Method::Qualifier::Immutable);
+    shape.addProperty("sides", [](const Shape *s) { return s->sides; }, [](Shape *s, int v) { s->sides = v; });
+    shape.addEvent<int, std::string>("resized");
+
+    std::vector<std::unique_ptr<MetaObject>> others;
+    for (int i = 0; i < 100; ++i)
+        others.push_back(std::make_unique<MetaObject>("SnapshotType" + std::to_string(i), typeid(Counter)));
+
+    // A fresh thread has an empty thread library
+    std::vector<std::byte> image, again;
+    std::thread([&] {
+        auto &library = Library::thread();
+        library.add(&shape);
+        library.add(&base);
+        for (const auto &other : others)
+            library.add(other.get());
+
+        image = library.snapshot();
+        again = library.snapshot();
+    }).join();
+
+    REQUIRE(image == again);
+
+    SchemaSnapshot snapshot(image);
+    REQUIRE(snapshot.verify());
+    REQUIRE(snapshot.types().size() == 102);
+
+    for (const auto &other : others)
+        REQUIRE(snapshot.find(other->name()));
+
+    REQUIRE_FALSE(snapshot.find("SnapshotMissing"));
+
+    const auto *type = snapshot.find("SnapshotShape");
+    REQUIRE(type);
+    REQUIRE(snapshot.string(type->name) == "SnapshotShape");
+    REQUIRE(type->fingerprint == SchemaSnapshot::fingerprint(typeid(Shape)));
+    REQUIRE(snapshot.bases(*type).size() == 1);
+    REQUIRE(snapshot.string(snapshot.bases(*type)[0].name) == "SnapshotBase");
+    REQUIRE(snapshot.constructors(*type).size() == 1);
+    REQUIRE(snapshot.arguments(snapshot.constructors(*type)[0]).size() == 1);
+
+    const auto *area = snapshot.method(*type, "area");
+    REQUIRE(area);
+    REQUIRE(snapshot.overloads(*area).size() == 2);
+    REQUIRE_FALSE(snapshot.method(*type, "perimeter"));
+
+    const auto *sides = snapshot.property(*type, "sides");
+    REQUIRE(sides);
+    REQUIRE(sides->type.fingerprint == SchemaSnapshot::fingerprint(typeid(int)));
+
+    const auto *resized = snapshot.event(*type, "resized");
+    REQUIRE(resized);
+    REQUIRE(snapshot.arguments(*resized).size() == 2);
+    REQUIRE(snapshot.arguments(*resized)[1].fingerprint == SchemaSnapshot::fingerprint(typeid(std::string)));
+
+    SECTION("Compatibility")
+    {
+        REQUIRE(snapshot.compatible(shape));
+        REQUIRE(snapshot.compatible(base));
+
+        // Added members are compatible, changed or missing ones are not
+        shape.addProperty("name", [](const Shape *) { return std::string(); }, [](Shape *, std::string) {});
+        REQUIRE(snapshot.compatible(shape));
+
+        MetaObject changed("SnapshotShape", typeid(Shape), {&base});
+        changed.addConstructor([](int sides) { return new Shape{sides}; });
+        changed.addMethod("area", [](Shape *s, double scale) -> double { return s->sides * scale; });
+        changed.addMethod("area", [](const Shape *s) -> double { return s->sides; }, Method::Qualifier::Immutable);
+        changed.addProperty("sides", [](const Shape *s) { return static_cast<long>(s->sides); }, [](Shape *s, long v) { s->sides = static_cast<int>(v); });
+        changed.addEvent<int, std::string>("resized");
+        REQUIRE_FALSE(snapshot.compatible(changed));
+
+        MetaObject renamed("SnapshotShape", typeid(Counter));
+        REQUIRE_FALSE(snapshot.compatible(renamed));
+
+        MetaObject unknown("SnapshotUnknown", typeid(Shape));
+        REQUIRE_FALSE(snapshot.compatible(unknown));
+    }
+
+    SECTION("Mapped File")
+    {
+        const auto path = (std::filesystem::temp_directory_path() / "reflection_schema_snapshot.bin").string();
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char *>(image.data()), static_cast<std::streamsize>(image.size()));
+        }
+
+        auto mapped = SchemaSnapshot::map(path);
+        REQUIRE(mapped.contentHash() == snapshot.contentHash());
+        REQUIRE(mapped.verify());
+        REQUIRE(mapped.compatible(shape));
+        REQUIRE(mapped.find("SnapshotType42"));
+
+        std::filesystem::remove(path);
+        REQUIRE_THROWS_AS(SchemaSnapshot::map(path), invalid_snapshot);
+    }
+
+    SECTION("Corruption")
+    {
+        auto corrupted = image;
+        corrupted.back() ^= std::byte(1);
+        REQUIRE_FALSE(SchemaSnapshot(corrupted).verify());
+
+        corrupted[0] = std::byte('X');
+        REQUIRE_THROWS_AS(SchemaSnapshot(corrupted), invalid_snapshot);
+        REQUIRE_THROWS_AS(SchemaSnapshot(std::span(image).first(32)), invalid_snapshot);
+    }
+}
+
+TEST_CASE("Arena Instantiation")
+{
+    struct Tracked
+    {
+        Tracked(int *alive, int value) : alive(alive), value(value) { ++*alive; }
+        ~Tracked() { --*alive; }
+
+        int *alive;
+        int value;
+        std::string label = "a label too long for the small string buffer";
+    };
+
+    int alive = 0;
+
+    MetaObject meta("ArenaTracked", typeid(Tracked));
+    meta.addConstructor<Tracked, int *, int>();
+    REQUIRE(meta.instanceSize() == sizeof(Tracked));
+    REQUIRE(meta.instanceAlignment() == alignof(Tracked));
+
+    SECTION("Heap")
+    {
+        auto instance = meta.instantiate<Tracked>(&alive, 1);
+        REQUIRE(instance->value == 1);
+        delete instance;
+        REQUIRE(alive == 0);
+    }
+
+    SECTION("Arena")
+    {
+        utility::arena arena(256);
+        for (int i = 0; i < 100; ++i)
+            REQUIRE(meta.construct<Tracked>(arena, &alive, i)->value == i);
+
+        REQUIRE(alive == 100);
+        REQUIRE(arena.allocated() >= 100 * sizeof(Tracked));
+
+        arena.release();
+        REQUIRE(alive == 0);
+        REQUIRE(arena.allocated() == 0);
+
+        // On a fresh thread, so that the local type does not outlive the thread library
+        int scopedAlive = -1;
+        std::thread([&] {
+            utility::arena scoped;
+            Library::thread().add(&meta);
+            Library::thread().construct<Tracked>("ArenaTracked", scoped, &alive, 2);
+            scopedAlive = alive;
+        }).join();
+
+        REQUIRE(scopedAlive == 1);
+        REQUIRE(alive == 0);
+    }
+
+    SECTION("Rewind")
+    {
+        // A marker taken before the first block rewinds to its start
+        utility::arena arena(4096);
+        const auto empty = arena.mark();
+        meta.construct<Tracked>(arena, &alive, 1);
+        arena.rewind(empty);
+        REQUIRE(alive == 0);
+        REQUIRE(arena.allocated() == 0);
+
+        // Objects adopted since the marker are destroyed, those adopted before are kept
+        meta.construct<Tracked>(arena, &alive, 2);
+        const auto position = arena.mark();
+        const auto used = arena.allocated();
+        for (int i = 0; i < 3; ++i)
+            meta.construct<Tracked>(arena, &alive, i);
+
+        REQUIRE(alive == 4);
+        arena.rewind(position);
+        REQUIRE(alive == 1);
+        REQUIRE(arena.allocated() == used);
+
+        // Memory given back is reused without the finalizers of the rewound objects
+        for (int i = 0; i < 3; ++i)
+            meta.construct<Tracked>(arena, &alive, i);
+
+        arena.release();
+        REQUIRE(alive == 0);
+    }
+
+    SECTION("Memory Resource")
+    {
+        std::pmr::unsynchronized_pool_resource resource;
+        auto instance = meta.construct<Tracked>(resource, &alive, 7);
+        REQUIRE(instance->value == 7);
+        REQUIRE(alive == 1);
+
+        meta.destroy(instance, resource);
+        REQUIRE(alive == 0);
+    }
+
+    SECTION("Pool")
+    {
+        Pool pool(meta);
+
+        std::vector<Tracked *> instances;
+        for (int i = 0; i < 20; ++i)
+            instances.push_back(pool.acquire<Tracked>(&alive, i));
+
+        REQUIRE(alive == 20);
+        REQUIRE(pool.capacity() >= 20);
+        REQUIRE(pool.available() == pool.capacity() - 20);
+
+        for (auto instance : instances)
+            pool.recycle(instance);
+
+        REQUIRE(alive == 0);
+        REQUIRE(pool.available() == pool.capacity());
+
+        // The most recently recycled block is reused first
+        auto again = pool.acquire<Tracked>(&alive, 3);
+        REQUIRE(again == instances.back());
+        REQUIRE(again->value == 3);
+        pool.recycle(again);
+    }
+
+    SECTION("Clone")
+    {
+        Reflectable original;
+
+        utility::arena arena;
+        REQUIRE(original.cloneTo(arena) != &original);
+
+        std::pmr::monotonic_buffer_resource resource;
+        auto copy = original.cloneTo(resource);
+        REQUIRE(copy != &original);
+        Reflectable::destroy(copy, resource);
+    }
+
+    SECTION("Errors")
+    {
+        MetaObject factory("ArenaFactory", typeid(Tracked));
+        factory.addConstructor([](int *alive, int value) { return new Tracked(alive, value); });
+
+        utility::arena arena;
+        REQUIRE_THROWS_AS(factory.construct<Tracked>(arena, &alive, 1), instantiation_failed);
+        REQUIRE_THROWS_AS(Pool(factory), instantiation_failed);
+        REQUIRE_THROWS_AS(meta.construct<Tracked>(arena, 1), unknown_constructor);
+        REQUIRE_THROWS_AS(meta.addConstructor<Counter>(), registration_failed);
+        REQUIRE(alive == 0);
+    }
+}
+
+TEST_CASE("Subtypes and Inherited Members")
+{
+    struct Base : Reflectable
+    {
+        int value = 1;
+    };
+
+    struct Derived : Base
+    {
+        std::string label = "derived";
+    };
+
+    MetaObject root("InheritRoot", typeid(Reflectable));
+    MetaObject base("InheritBase", typeid(Base), {&root});
+    MetaObject mixin("InheritMixin", typeid(Counter));
+    MetaObject derived("InheritDerived", typeid(Derived), {&base, &mixin});
+    MetaObject unrelated("InheritUnrelated", typeid(Counter));
+
+    SECTION("Subtypes")
+    {
+        REQUIRE(derived.isSubtypeOf(derived));
+        REQUIRE(derived.isSubtypeOf(base));
+        REQUIRE(derived.isSubtypeOf(root));
+        REQUIRE(derived.isSubtypeOf(mixin));
+        REQUIRE(base.isSubtypeOf(root));
+
+        REQUIRE_FALSE(derived.isSubtypeOf(unrelated));
+        REQUIRE_FALSE(base.isSubtypeOf(derived));
+        REQUIRE_FALSE(root.isSubtypeOf(base));
+        REQUIRE_FALSE(mixin.isSubtypeOf(root));
+
+        REQUIRE(derived.ancestors().size() == 3);
+        REQUIRE(derived.hasBase("InheritRoot"));
+        REQUIRE(&derived.base("InheritMixin") == &mixin);
+        REQUIRE_FALSE(derived.hasBase("InheritUnrelated"));
+    }
+
+    SECTION("Inherited Members")
+    {
+        base.addMethod("name", [](const Base *) { return std::string("base"); }, Method::Qualifier::Immutable);
+        base.addMethod("value", [](const Base *b) { return b->value; }, Method::Qualifier::Immutable);
+        base.addProperty("value", [](const Base *b) { return b->value; }, [](Base *b, int v) { b->value = v; });
+        base.addEvent<int>("changed");
+        mixin.addMethod("mixed", [](const Counter *c) { return c->count; }, Method::Qualifier::Immutable);
+        derived.addMethod("name", [](const Derived *d) { return d->label; }, Method::Qualifier::Immutable);
+        derived.addEvent<std::string>("renamed");
+
+        // Until sealed only own members are found, and bases have to be sealed first
+        REQUIRE_FALSE(derived.hasMethod("value"));
+        REQUIRE_THROWS_AS(derived.seal(), registration_failed);
+
+        root.seal();
+        base.seal();
+        mixin.seal();
+        derived.seal();
+
+        Derived instance;
+        REQUIRE(derived.hasMethod("value"));
+        REQUIRE(derived.method("value").invoke<int, const Derived>(&instance, Method::Qualifier::Immutable) == 1);
+        REQUIRE(derived.method("name").invoke<std::string, const Derived>(&instance, Method::Qualifier::Immutable) == "derived");
+        REQUIRE(base.method("name").invoke<std::string, const Base>(&instance, Method::Qualifier::Immutable) == "base");
+
+        derived.property("value").set<Derived, int>(&instance, 5);
+        REQUIRE(instance.value == 5);
+        REQUIRE(derived.propertyHandle<int>("value").get(&instance) == 5);
+
+        // Members of other than first bases are not inherited
+        REQUIRE_FALSE(derived.hasMethod("mixed"));
+        REQUIRE(derived.methods().size() == 1);
+
+        // Own events are numbered after the inherited ones
+        REQUIRE(derived.event("changed").ordinal() == 0);
+        REQUIRE(derived.event("renamed").ordinal() == 1);
+        REQUIRE(base.event("changed").ordinal() == 0);
+    }
+}
+
+
+TEST_CASE("Dynamic Invocation")
+{
+    SECTION("Values")
+    {
+        Value number = 42;
+        Value text = "short";
+        Value large = std::vector<int>(100, 1);
+        Value empty;
+
+        REQUIRE(number.holds<int>());
+        REQUIRE(number.isInline());
+        REQUIRE(number.get<int>() == 42);
+        REQUIRE(text.holds<std::string>());
+        REQUIRE(text.isInline());
+        REQUIRE(large.get<std::vector<int>>().size() == 100);
+        REQUIRE(empty.empty());
+        REQUIRE(empty.type() == typeid(void));
+
+        REQUIRE(number.tryGet<double>() == nullptr);
+        REQUIRE_THROWS_AS(number.get<long>(), invalid_value_type);
+
+        auto copy = text;
+        auto moved = std::move(copy);
+        REQUIRE(moved.get<std::string>() == "short");
+        REQUIRE(text.get<std::string>() == "short");
+
+        large = number;
+        REQUIRE(large.get<int>() == 42);
+
+        Value unique = std::make_unique<int>(7);
+        REQUIRE_THROWS_AS(Value(unique), invalid_value_type);
+        REQUIRE(*Value(std::move(unique)).get<std::unique_ptr<int>>() == 7);
+
+        REQUIRE(Value::signatureHash(std::array<Value, 2>{1, 2.0}) == utility::signatureHash<int, double>());
+    }
+
+    SECTION("Invocation")
+    {
+        MetaObject meta("Dynamic", typeid(Counter));
+        meta.addMethod("add", &Counter::add);
+        meta.addMethod("get", &Counter::get);
+        meta.addMethod("twice", &twice);
+        meta.addMethod("twice", [](int value, int factor) -> int { return value * factor; });
+        meta.addMethod("greet", [](const std::string &name) -> std::string { return "hello " + name; });
+        meta.addMethod("append", [](Counter *, std::string name, std::string &&suffix) { return name + suffix; }, Method::Qualifier::Mutable);
+
+        Counter counter;
+
+        ArgumentFrame add(1);
+        add[0] = 5;
+        REQUIRE(meta.method("add").invokeDynamic(&counter, add, Method::Qualifier::Mutable).empty());
+        REQUIRE(counter.count == 5);
+
+        // const methods can be called on non-const objects
+        REQUIRE(meta.method("get").invokeDynamic(&counter, {}, Method::Qualifier::Mutable).get<int>() == 5);
+
+        {
+            ArgumentFrame arguments(2);
+            arguments[0] = 21;
+            arguments[1] = 3;
+            REQUIRE(meta.method("twice").invokeDynamic(arguments).get<int>() == 63);
+
+            // Frames nest like the calls building them
+            ArgumentFrame single(1);
+            single[0] = 21;
+            REQUIRE(meta.method("twice").invokeDynamic(single).get<int>() == 42);
+        }
+
+        ArgumentFrame greet(1);
+        greet[0] = "world";
+        REQUIRE(meta.method("greet").invokeDynamic(greet).get<std::string>() == "hello world");
+        REQUIRE(greet[0].get<std::string>() == "world");
+
+        ArgumentFrame append(2);
+        append[0] = "a long enough string to be allocated on the heap";
+        append[1] = "!";
+        REQUIRE(meta.method("append").invokeDynamic(&counter, append, Method::Qualifier::Mutable).get<std::string>() == "a long enough string to be allocated on the heap!");
+        REQUIRE(append[0].get<std::string>().empty());
+
+        ArgumentFrame wrong(1);
+        wrong[0] = 1.5;
+        REQUIRE_THROWS_AS(meta.method("twice").invokeDynamic(wrong), unknown_method);
+        REQUIRE_THROWS_AS(meta.method("twice").overloads().front()->invokeDynamic(wrong), invalid_method_type);
+        REQUIRE_THROWS_AS(meta.method("add").invokeDynamic(&counter, add, Method::Qualifier::Static), unknown_method);
+
+        meta.seal();
+        REQUIRE(meta.method("greet").invokeDynamic(greet).get<std::string>() == "hello world");
+        REQUIRE(meta.method("add").invokeDynamic(&counter, add, Method::Qualifier::Mutable).empty());
+        REQUIRE(counter.count == 10);
+    }
+}
+
+
+TEST_CASE("Batch Invocation")
+{
+    MetaObject meta("Batch", typeid(Counter));
+    meta.addMethod("add", &Counter::add);
+    meta.addMethod("get", &Counter::get);
+    meta.addMethod("fail", [](Counter *counter) {
+        if (counter->count == 13)
+            throw std::runtime_error("unlucky");
+    }, Method::Qualifier::Mutable);
+    meta.seal();
+
+    std::vector<Counter> counters(10000);
+    std::vector<Counter *> instances;
+    for (auto &counter : counters)
+        instances.push_back(&counter);
+
+    SECTION("Sequential")
+    {
+        meta.method("add").invokeAll(std::span(instances), 2);
+        REQUIRE(std::ranges::all_of(counters, [](const auto &counter) { return counter.count == 2; }));
+
+        std::vector<int> results(instances.size());
+        meta.method("get").invokeAll(std::span(instances), std::span(results));
+        REQUIRE(std::ranges::all_of(results, [](int result) { return result == 2; }));
+
+        std::vector<const Counter *> immutable(instances.begin(), instances.end());
+        std::vector<double> doubles(immutable.size());
+        REQUIRE_THROWS_AS(meta.method("add").invokeAll(std::span(immutable), 1), unknown_method);
+        REQUIRE_THROWS_AS(meta.method("get").invokeAll(std::span(instances), std::span(results).first(10)), invalid_method_type);
+        REQUIRE_THROWS_AS(meta.method("get").invokeAll<double>(std::span(immutable), std::span(doubles)), invalid_method_type);
+    }
+
+    SECTION("Parallel")
+    {
+        ThreadPool pool(3);
+        REQUIRE(pool.workers() == 3);
+
+        for (int i = 0; i < 10; ++i)
+            meta.method("add").invokeAll(pool, 64, std::span(instances), 1);
+
+        REQUIRE(std::ranges::all_of(counters, [](const auto &counter) { return counter.count == 10; }));
+
+        counters[5000].count = 7;
+        std::vector<int> results(instances.size());
+        meta.method("get").invokeAll(pool, 1, std::span(instances), std::span(results));
+        REQUIRE(results[5000] == 7);
+        REQUIRE(std::accumulate(results.begin(), results.end(), 0) == 10 * 9999 + 7);
+
+        counters[7777].count = 13;
+        REQUIRE_THROWS_AS(meta.method("fail").invokeAll(pool, 16, std::span(instances)), std::runtime_error);
+
+        // Loops started from within a loop run inline
+        std::atomic<std::size_t> covered = 0;
+        pool.parallelFor(100, 1, [&](std::size_t, std::size_t) {
+            pool.parallelFor(100, 10, [&](std::size_t begin, std::size_t end) { covered += end - begin; });
+        });
+        REQUIRE(covered == 100 * 100);
+
+        ThreadPool inline_(0);
+        meta.method("add").invokeAll(inline_, 1, std::span(instances), 1);
+        REQUIRE(counters[0].count == 11);
+    }
+}
+
+
+TEST_CASE("Member Metrics")
+{
+    for (std::uint64_t nanoseconds : {0ull, 3ull, 4ull, 7ull, 8ull, 1000ull, 123456789ull})
+    {
+        const auto bucket = Metrics::Snapshot::bucket(nanoseconds);
+        REQUIRE(Metrics::Snapshot::lowerBound(bucket) <= nanoseconds);
+        REQUIRE(Metrics::Snapshot::lowerBound(bucket + 1) > nanoseconds);
+    }
+
+    // Registers with the library of its own thread, which must not outlive the MetaObject
+    std::thread([] {
+        MetaObject meta("Measured", typeid(Counter));
+        meta.addMethod("add", &Counter::add);
+        meta.addMethod("get", &Counter::get);
+        meta.addProperty("count",
+            [](const Counter *instance) -> int { return instance->count; },
+            [](Counter *instance, int value) { instance->count = value; });
+        meta.seal();
+        Library::thread().add(&meta);
+
+        Counter counter;
+        std::vector<Counter *> instances(5, &counter);
+
+        Metrics::enable(true);
+        Metrics::sample(1);
+
+        for (int i = 0; i < 10; ++i)
+            meta.method("add").invoke<void, Counter, int>(&counter, 1, Method::Qualifier::Mutable);
+
+        meta.method("add").invokeAll(std::span(instances), 1);
+        REQUIRE(meta.methodHandle<int>("get", Method::Qualifier::Immutable).invoke(&counter) == 15);
+        meta.propertyHandle<int>("count").set(&counter, 3);
+
+        Metrics::enable(false);
+        Metrics::sample(0);
+        meta.method("add").invoke<void, Counter, int>(&counter, 1, Method::Qualifier::Mutable);
+
+        const auto metrics = Library::thread().metrics();
+
+#ifdef REFLECTION_METRICS
+        const auto find = [&metrics](const std::string &member) {
+            return std::ranges::find(metrics, member, &MemberMetrics::member)->metrics;
+        };
+
+        REQUIRE(metrics.size() == 3);
+
+        const auto add = find("add");
+        REQUIRE(add.calls == 15);
+        REQUIRE(add.samples == 10);
+        REQUIRE(std::accumulate(add.histogram.begin(), add.histogram.end(), std::uint64_t(0)) == 10);
+        REQUIRE(add.percentile(0.5) <= add.percentile(0.99));
+
+        REQUIRE(find("get").calls == 1);
+        REQUIRE(find("count").calls == 1);
+
+        Library::thread().resetMetrics();
+        REQUIRE(Library::thread().metrics().empty());
+#else
+        REQUIRE(metrics.empty());
+#endif
+    }).join();
+}
+
+TEST_CASE("Memory Usage")
+{
+    MetaObject meta("MemoryUsageTypeWithANameTooLongForTheSmallStringBuffer", typeid(Reflectable));
+    REQUIRE(meta.memoryUsage().names > meta.name().size());
+    REQUIRE(meta.memoryUsage().captures == 0);
+
+    std::array<char, 256> payload{};
+    meta.addMethod("inline", [](Reflectable *, int value) -> int { return value; }, Method::Qualifier::Mutable);
+    meta.addMethod("inline", [](Reflectable *, int value, int factor) -> int { return value * factor; }, Method::Qualifier::Mutable);
+    meta.addMethod("captured", [payload](const Reflectable *) -> int { return payload[0]; }, Method::Qualifier::Immutable);
+    meta.addProperty("count", [](const Reflectable *) -> int { return 0; }, [](Reflectable *, int) {});
+    meta.addEvent<int, int>("changed");
+
+    const auto method = meta.method("inline").memoryUsage();
+    REQUIRE(method.names == 0);
+    REQUIRE(method.overloads > 0);
+    REQUIRE(method.argumentTypes >= 3 * sizeof(std::type_index));
+    REQUIRE(method.captures == 0);
+
+    REQUIRE(meta.method("captured").memoryUsage().captures >= sizeof(payload));
+    REQUIRE(meta.property("count").memoryUsage().captures == 0);
+    REQUIRE(meta.event("changed").memoryUsage().argumentTypes >= 2 * sizeof(std::type_index));
+
+    const auto unsealed = meta.memoryUsage();
+    REQUIRE(unsealed.captures >= sizeof(payload));
+    REQUIRE(unsealed.tables > 0);
+    REQUIRE(unsealed.subscriptions == 0);
+    REQUIRE(unsealed.total() == unsealed.names + unsealed.tables + unsealed.overloads + unsealed.argumentTypes + unsealed.captures + unsealed.metrics);
+
+    // Sealing compacts the tables but keeps what the members own
+    meta.seal();
+    const auto sealed = meta.memoryUsage();
+    REQUIRE(sealed.names == unsealed.names);
+    REQUIRE(sealed.captures == unsealed.captures);
+    REQUIRE(sealed.argumentTypes == unsealed.argumentTypes);
+
+    struct Emitter : Reflectable
+    {
+        const MetaObject *meta;
+        const MetaObject &metaObject() const noexcept override { return *meta; }
+    };
+
+    Emitter emitter;
+    emitter.meta = &meta;
+    REQUIRE(emitter.memoryUsage().total() == 0);
+
+    emitter.subscribe("changed", [](int, int) {});
+    emitter.subscribe("changed", [payload](int, int) {});
+    REQUIRE(emitter.memoryUsage().subscriptions >= 2 * sizeof(Event::Subscription));
+    REQUIRE(emitter.memoryUsage().captures >= sizeof(payload));
+
+    // The outer list keeps its capacity
+    emitter.unsubscribe();
+    REQUIRE(emitter.memoryUsage().captures == 0);
+
+    // Registers with the library of its own thread, which must not outlive the MetaObject
+    std::thread([&meta, &sealed] {
+        const auto empty = Library::thread().memoryUsage();
+        Library::thread().add(&meta);
+
+        const auto registered = Library::thread().memoryUsage();
+        REQUIRE(registered.captures == sealed.captures);
+        REQUIRE(registered.tables >= empty.tables + sealed.tables);
+    }).join();
+}
+
+TEST_CASE("Non-Throwing Access")
+{
+    MetaObject meta("Probed", typeid(Counter));
+    meta.addMethod("add", &Counter::add);
+    meta.addMethod("get", &Counter::get);
+    meta.addMethod("twice", &twice);
+    meta.addProperty("count",
+        [](const Counter *instance) -> int { return instance->count; },
+        [](Counter *instance, int value) { instance->count = value; });
+
+    struct Probed : Counter
+    {
+        const MetaObject *meta;
+        const MetaObject &metaObject() const noexcept override { return *meta; }
+    };
+
+    Probed probed;
+    probed.meta = &meta;
+
+    REQUIRE(meta.findMethod("add") == &meta.method("add"));
+    REQUIRE(meta.findMethod("missing") == nullptr);
+    REQUIRE(meta.findMethod("a never interned name") == nullptr);
+    REQUIRE(meta.findProperty("count") == &meta.property("count"));
+    REQUIRE(meta.findEvent("count") == nullptr);
+
+    REQUIRE(probed.tryInvoke("add", 2).hasValue());
+    REQUIRE(std::as_const(probed).tryInvoke<int>("get").value() == 2);
+    REQUIRE(meta.method("twice").tryInvoke<int>(21).value() == 42);
+
+    auto unknown = probed.tryInvoke<int>("missing", 1);
+    REQUIRE_FALSE(unknown);
+    REQUIRE(unknown.error().error() == Error::UnknownMethod);
+    REQUIRE(unknown.error().message() == "missing");
+    REQUIRE(std::move(unknown).valueOr(-1) == -1);
+
+    // Const instances only see const overloads
+    auto signature = std::as_const(probed).tryInvoke("add", 1);
+    REQUIRE(signature.error().error() == Error::UnknownSignature);
+    REQUIRE(signature.error().message() == "unknown signature add(" + utility::signatureString<int>() + ") for method add");
+    REQUIRE_THROWS_AS(signature.value(), unknown_method);
+
+    auto returnType = probed.tryInvoke<double>("get");
+    REQUIRE(returnType.error().error() == Error::InvalidMethodType);
+    REQUIRE_THROWS_AS(returnType.value(), invalid_method_type);
+
+    REQUIRE(probed.tryGet<int>("count").value() == 2);
+    REQUIRE(probed.trySet("count", 5).hasValue());
+    REQUIRE(probed.count == 5);
+    REQUIRE(probed.tryGet<double>("count").error().error() == Error::InvalidPropertyType);
+    REQUIRE_THROWS_AS(probed.trySet("count", 1.0).value(), invalid_property_type);
+    REQUIRE_THROWS_AS(probed.tryGet<int>("missing").value(), unknown_property);
+
+    // Results can hold references
+    int target = 0;
+    meta.addMethod("self", [&target]() -> int & { return target; });
+    meta.method("self").tryInvoke<int &>().value() = 7;
+    REQUIRE(target == 7);
+
+    std::thread([&meta] {
+        REQUIRE(Library::thread().findMetaObject("Probed") == nullptr);
+        Library::thread().add(&meta);
+        REQUIRE(Library::thread().findMetaObject("Probed") == &meta);
+        REQUIRE(Library::thread().findMetaObject(Symbol::intern("Probed")) == &meta);
+    }).join();
+}
+
+namespace
+{
+    struct DeclaredShape : Reflectable
+    {
+        int width = 0;
+
+        int area() const { return width * width; }
+        const MetaObject &metaObject() const noexcept override;
+    };
+
+    struct DeclaredSquare : DeclaredShape
+    {
+        int side() const { return width; }
+        void setSide(int value) { width = value; }
+        void scale(int factor) { width *= factor; }
+    };
+
+    constexpr MemberDeclaration declaredShapeMembers[] = {
+        declare::constructor<DeclaredShape>(),
+        declare::method<&DeclaredShape::area>("area"),
+        declare::property<&DeclaredShape::width>("width"),
+        declare::event<int>("resized")};
+
+    constexpr TypeDeclaration declaredShapeType{"DeclaredShape", &typeid(DeclaredShape), declaredShapeMembers};
+
+    constexpr MemberDeclaration declaredSquareMembers[] = {
+        declare::method<&DeclaredSquare::scale>("scale"),
+        declare::method<&twice>("twice"),
+        declare::property<&DeclaredSquare::side, &DeclaredSquare::setSide>("side")};
+
+    constexpr const TypeDeclaration *declaredSquareBases[] = {&declaredShapeType};
+    constexpr TypeDeclaration declaredSquareType{"DeclaredSquare", &typeid(DeclaredSquare), declaredSquareMembers, declaredSquareBases};
+
+    static_assert(declaredSquareType.members.size() == 3 && declaredSquareType.bases.front()->name == "DeclaredShape");
+
+    const MetaObject &DeclaredShape::metaObject() const noexcept
+    {
+        return declared<declaredShapeType>();
+    }
+}
+
+TEST_CASE("Declared Types")
+{
+    // Registered with the library of its own thread, which owns the materialized types
+    std::thread([] {
+        auto &library = Library::thread();
+
+        const TypeDeclaration *declarations[] = {&declaredSquareType, &declaredShapeType};
+        library.add(declarations);
+        REQUIRE(library.exists("DeclaredShape"));
+        REQUIRE(library.memoryUsage().overloads == 0);
+        REQUIRE_THROWS_AS(library.add(declaredShapeType), registration_failed);
+
+        // Materializing a type materializes its bases first
+        const auto &square = library.metaObject("DeclaredSquare");
+        const auto &shape = library.metaObject("DeclaredShape");
+        REQUIRE(&library.metaObject("DeclaredSquare") == &square);
+        REQUIRE(square.isSubtypeOf(shape));
+        REQUIRE(square.hasMethod("area"));
+        REQUIRE(square.method("twice").invoke<int>(21) == 42);
+
+        DeclaredSquare instance;
+        square.property("side").set(&instance, 3);
+        square.method("scale").invoke<void, DeclaredSquare, int>(&instance, 2, Method::Qualifier::Mutable);
+        REQUIRE(square.property("width").get<DeclaredSquare, int>(&instance) == 6);
+        REQUIRE(square.method("area").invoke<int, const DeclaredSquare>(&instance, Method::Qualifier::Immutable) == 36);
+        REQUIRE(shape.event("resized").ordinal() == 0);
+
+        auto created = std::unique_ptr<DeclaredShape>(shape.instantiate<DeclaredShape>());
+        REQUIRE(created->width == 0);
+
+        REQUIRE(library.metaObjects().size() == 2);
+
+        // Declared entries have no symbol, the empty symbol of an unknown name must not match them
+        library.finalize();
+        REQUIRE(library.findMetaObject(Symbol::find("DeclaredTypeNeverRegistered")) == nullptr);
+        REQUIRE_FALSE(library.exists(Symbol()));
+        REQUIRE(library.findMetaObject(Symbol::intern("DeclaredShape")) == &shape);
+    }).join();
+
+    // Declared types with the global library are found through declared()
+    Library::global().add(declaredShapeType);
+    DeclaredShape shape;
+    shape.width = 4;
+    REQUIRE(&shape.metaObject() == &Library::global().metaObject("DeclaredShape"));
+    REQUIRE(shape.invoke<int>("area") == 16);
+}
+
+TEST_CASE("Lazy Registration")
+{
+    static std::atomic<int> built = 0;
+
+    const auto counter = [](std::string_view name, const Library &) {
+        ++built;
+        auto type = std::make_unique<MetaObject>(std::string(name), typeid(Counter));
+        type->addMethod("add", &Counter::add);
+        type->seal();
+        return type;
+    };
+
+    const auto derived = [](std::string_view name, const Library &library) {
+        ++built;
+        auto type = std::make_unique<MetaObject>(std::string(name), typeid(Counter), std::vector{&library.metaObject("LazyCounter")});
+        type->seal();
+        return type;
+    };
+
+    const auto misnamed = [](std::string_view, const Library &) {
+        return std::make_unique<MetaObject>("Elsewhere", typeid(Counter));
+    };
+
+    std::thread([&] {
+        auto &library = Library::thread();
+        library.add("LazyCounter", counter);
+        library.add("LazyDerived", derived);
+        library.add("LazyMisnamed", misnamed);
+        REQUIRE_THROWS_AS(library.add("LazyCounter", counter), registration_failed);
+
+        // Rejecting a duplicate never builds the type registered before
+        MetaObject duplicate("LazyCounter", typeid(Counter));
+        REQUIRE_THROWS_AS(library.add(&duplicate), registration_failed);
+        MetaObject misnamedDuplicate("LazyMisnamed", typeid(Counter));
+        REQUIRE_THROWS_WITH(library.add(&misnamedDuplicate), Catch::Contains("already registered"));
+
+        REQUIRE(library.exists("LazyCounter"));
+        REQUIRE(built == 0);
+
+        // Building a type builds its bases first, and only once
+        const auto &type = library.metaObject("LazyDerived");
+        REQUIRE(built == 2);
+        REQUIRE(type.isSubtypeOf(library.metaObject("LazyCounter")));
+        REQUIRE(&library.metaObject(Symbol::intern("LazyCounter")) == &library.metaObject("LazyCounter"));
+        REQUIRE(built == 2);
+
+        Counter instance;
+        type.method("add").invoke<void, Counter, int>(&instance, 3, Method::Qualifier::Mutable);
+        REQUIRE(instance.count == 3);
+
+        REQUIRE_THROWS_AS(library.metaObject("LazyMisnamed"), registration_failed);
+        REQUIRE_THROWS_AS(library.metaObject("LazyMisnamed"), registration_failed);
+    }).join();
+
+    // Concurrent first lookups wait for the one building the type
+    Library::global().add("LazyConcurrent", counter);
+    built = 0;
+
+    std::vector<std::thread> threads;
+    std::vector<const MetaObject *> found(4);
+    for (std::size_t i = 0; i < found.size(); ++i)
+        threads.emplace_back([&found, i] { found[i] = &Library::global().metaObject("LazyConcurrent"); });
+
+    for (auto &thread : threads)
+        thread.join();
+
+    REQUIRE(built == 1);
+    REQUIRE(std::ranges::count(found, found.front()) == 4);
+    REQUIRE(found.front()->hasMethod("add"));
+}
+
+TEST_CASE("Field Properties")
+{
+    struct Point
+    {
+        std::int32_t id = 0;
+        float x = 0, y = 0, z = 0;
+        std::string label;
+    };
+
+    MetaObject meta("FieldPoint", typeid(Point));
+    meta.addProperty("id", &Point::id);
+    meta.addProperty("x", &Point::x);
+    meta.addProperty("y", &Point::y);
+    meta.addProperty("z", &Point::z);
+    meta.addProperty("label", &Point::label);
+    REQUIRE_THROWS_AS(meta.addProperty("x", &Point::x), registration_failed);
+
+    const auto &layout = meta.property("y").layout();
+    REQUIRE(layout);
+    Point origin;
+    REQUIRE(layout->offset == static_cast<std::size_t>(reinterpret_cast<char *>(&origin.y) - reinterpret_cast<char *>(&origin)));
+    REQUIRE(layout->size == sizeof(float));
+    REQUIRE(layout->alignment == alignof(float));
+    REQUIRE(layout->triviallyCopyable);
+    REQUIRE_FALSE(meta.property("label").layout()->triviallyCopyable);
+
+    struct Polymorphic
+    {
+        virtual ~Polymorphic() = default;
+        int value = 1;
+    };
+
+    Polymorphic polymorphic;
+    MetaObject derived("FieldPolymorphic", typeid(Polymorphic));
+    derived.addProperty("value", &Polymorphic::value);
+    REQUIRE(derived.property("value").layout()->offset == static_cast<std::size_t>(reinterpret_cast<char *>(&polymorphic.value) - reinterpret_cast<char *>(&polymorphic)));
+    REQUIRE(derived.property("value").get<Polymorphic, int>(&polymorphic) == 1);
+
+    SECTION("Access")
+    {
+        Point point;
+        meta.property("x").set(&point, 1.5f);
+        meta.property("label").set(&point, std::string("origin"));
+        REQUIRE(point.x == 1.5f);
+        REQUIRE(point.label == "origin");
+        REQUIRE(meta.property("x").get<Point, float>(&point) == 1.5f);
+        REQUIRE(meta.property("label").get<Point, std::string>(&point) == "origin");
+
+        REQUIRE_THROWS_AS((meta.property("x").get<Point, double>(&point)), invalid_property_type);
+        REQUIRE_FALSE((meta.property("x").tryGet<Point, double>(&point)));
+        REQUIRE(meta.property("z").trySet(&point, 3.0f));
+        REQUIRE(point.z == 3.0f);
+
+        const auto handle = meta.propertyHandle<float>("y");
+        handle.set(&point, 2.0f);
+        REQUIRE(point.y == 2.0f);
+        REQUIRE(handle.get(&point) == 2.0f);
+    }
+
+    SECTION("Columns")
+    {
+        std::vector<Point> points(10);
+        std::vector<float> column(points.size());
+        for (std::size_t i = 0; i < column.size(); ++i)
+            column[i] = static_cast<float>(i);
+
+        meta.property("y").scatter<Point, float>(std::span<Point>(points), column);
+        REQUIRE(points[7].y == 7.0f);
+
+        std::vector<const Point *> pointers;
+        for (const auto &point : points)
+            pointers.push_back(&point);
+
+        std::vector<float> gathered(points.size());
+        meta.property("y").gather<Point, float>(pointers, gathered);
+        REQUIRE(gathered == column);
+
+        std::vector<std::string> labels(points.size(), "point");
+        meta.property("label").scatter<Point, std::string>(std::span<Point>(points), labels);
+        std::vector<std::string> read(points.size());
+        meta.property("label").gather<Point, std::string>(std::span<const Point>(points), read);
+        REQUIRE(read == labels);
+    }
+
+    SECTION("Serialization")
+    {
+        // Adjacent fields x, y and z are copied as one block, the encoding does not change
+        MetaObject accessors("AccessorPoint", typeid(Point));
+        accessors.addProperty("id", [](const Point *p) { return p->id; }, [](Point *p, std::int32_t v) { p->id = v; });
+        accessors.addProperty("x", [](const Point *p) { return p->x; }, [](Point *p, float v) { p->x = v; });
+        accessors.addProperty("y", [](const Point *p) { return p->y; }, [](Point *p, float v) { p->y = v; });
+        accessors.addProperty("z", [](const Point *p) { return p->z; }, [](Point *p, float v) { p->z = v; });
+
+        MetaObject fields("FieldOnlyPoint", typeid(Point));
+        fields.addProperty("id", &Point::id);
+        fields.addProperty("x", &Point::x);
+        fields.addProperty("y", &Point::y);
+        fields.addProperty("z", &Point::z);
+
+        Serializer expected(accessors);
+        Serializer serializer(fields);
+        REQUIRE(serializer.fields() == 4);
+        REQUIRE(serializer.fixedSize() == expected.fixedSize());
+
+        std::vector<Point> points;
+        for (int i = 0; i < 10; ++i)
+            points.push_back(Point{i, i * 1.0f, i * 2.0f, i * 3.0f, {}});
+
+        std::array<std::byte, 16> single;
+        std::array<std::byte, 16> reference;
+        REQUIRE(serializer.encode(&points[3], std::span(single)) == expected.encode(&points[3], std::span(reference)));
+        REQUIRE(single == reference);
+
+        Point decoded;
+        serializer.decode(&decoded, std::span<const std::byte>(single));
+        REQUIRE((decoded.id == 3 && decoded.x == 3.0f && decoded.y == 6.0f && decoded.z == 9.0f));
+
+        std::array<std::byte, 64> buffer;
+        std::vector<std::byte> stream, referenceStream;
+        serializer.encode(std::span<const Point>(points), std::span(buffer), [&](std::span<const std::byte> part) {
+            stream.insert(stream.end(), part.begin(), part.end());
+        });
+        expected.encode(std::span<const Point>(points), std::span(buffer), [&](std::span<const std::byte> part) {
+            referenceStream.insert(referenceStream.end(), part.begin(), part.end());
+        });
+        REQUIRE(stream == referenceStream);
+    }
+}
+
+namespace
+{
+    // Counts deep copies, moves are free
+    struct Payload
+    {
+        static inline int copies = 0;
+
+        std::vector<double> samples;
+
+        Payload() = default;
+        explicit Payload(std::size_t size) : samples(size, 1.0) {}
+        Payload(const Payload &other) : samples(other.samples) { ++copies; }
+        Payload(Payload &&other) noexcept = default;
+
+        Payload &operator=(const Payload &other)
+        {
+            samples = other.samples;
+            ++copies;
+            return *this;
+        }
+
+        Payload &operator=(Payload &&other) noexcept = default;
+    };
+
+    struct Document
+    {
+        Payload payload;
+        std::string text;
+        std::vector<double> values;
+    };
+}
+
+TEST_CASE("Reference Properties")
+{
+    MetaObject meta("ReferenceDocument", typeid(Document));
+    meta.addProperty("payload", [](const Document *d) -> const Payload & { return d->payload; }, [](Document *d, Payload &&p) { d->payload = std::move(p); });
+    meta.addProperty("copied", [](const Document *d) { return d->payload; }, [](Document *d, Payload p) { d->payload = std::move(p); });
+    meta.addProperty("text", [](const Document *d) -> const std::string & { return d->text; }, [](Document *d, std::string &&t) { d->text = std::move(t); });
+    meta.addProperty("label", [](const Document *d) { return d->text; }, [](Document *d, std::string t) { d->text = std::move(t); });
+    meta.addProperty("values", &Document::values);
+
+    Document document;
+    Payload::copies = 0;
+
+    const auto &payload = meta.property("payload");
+    REQUIRE(payload.byReference());
+    REQUIRE_FALSE(meta.property("copied").byReference());
+    REQUIRE(meta.property("values").byReference());
+    REQUIRE(payload.type() == typeid(Payload));
+    REQUIRE(payload.hash() == meta.property("copied").hash());
+
+    SECTION("Moves")
+    {
+        // Setters are handed rvalues all the way down, by value or by rvalue reference
+        payload.set(&document, Payload(1000));
+        meta.property("copied").set(&document, Payload(10));
+        meta.propertyHandle<Payload>("payload").set(&document, Payload(100));
+        REQUIRE(Payload::copies == 0);
+        REQUIRE(document.payload.samples.size() == 100);
+
+        Payload kept(5);
+        payload.set(&document, kept);
+        REQUIRE(Payload::copies == 1);
+    }
+
+    SECTION("References")
+    {
+        document.payload = Payload(1000);
+
+        REQUIRE(&payload.get<Document, const Payload &>(&document) == &document.payload);
+        REQUIRE(&payload.tryGet<Document, const Payload &>(&document).value() == &document.payload);
+        REQUIRE(&meta.propertyHandle<const Payload &>("payload").get(&document) == &document.payload);
+        REQUIRE(Payload::copies == 0);
+
+        // Reading by value copies once, from the reference
+        REQUIRE(payload.get<Document, Payload>(&document).samples.size() == 1000);
+        REQUIRE(meta.propertyHandle<Payload>("payload").get(&document).samples.size() == 1000);
+        REQUIRE(Payload::copies == 2);
+
+        // Getters returning by value cannot be referred to
+        REQUIRE_THROWS_AS((meta.property("copied").get<Document, const Payload &>(&document)), invalid_property_type);
+        REQUIRE((meta.property("copied").tryGet<Document, const Payload &>(&document).error().error() == Error::InvalidPropertyType));
+        REQUIRE_THROWS_AS(meta.propertyHandle<const Payload &>("copied"), invalid_property_type);
+    }
+
+    SECTION("Views")
+    {
+        document.text = "a text long enough to be stored on the heap";
+        document.values = {1.0, 2.0, 3.0};
+
+        const auto text = meta.property("text").get<Document, std::string_view>(&document);
+        REQUIRE(text.data() == document.text.data());
+        REQUIRE(text == document.text);
+
+        const auto values = meta.property("values").get<Document, std::span<const double>>(&document);
+        REQUIRE(values.data() == document.values.data());
+        REQUIRE(values.size() == 3);
+
+        REQUIRE_THROWS_AS((meta.property("label").get<Document, std::string_view>(&document)), invalid_property_type);
+        REQUIRE_THROWS_AS((meta.property("text").get<Document, std::span<const double>>(&document)), invalid_property_type);
+        REQUIRE(meta.property("label").get<Document, std::string>(&document) == document.text);
+    }
+}
+
+namespace
+{
+    struct OrdinalEmitter : Reflectable
+    {
+        static inline const MetaObject *type = nullptr;
+
+        const MetaObject &metaObject() const noexcept override { return *type; }
+    };
+}
+
+TEST_CASE("Event Ordinals")
+{
+    MetaObject base("OrdinalBase", typeid(Reflectable));
+    MetaObject derived("OrdinalDerived", typeid(OrdinalEmitter), {&base});
+    OrdinalEmitter::type = &derived;
+
+    base.addEvent<int>("changed");
+    derived.addEvent<std::string>("renamed");
+
+    // Ordinals are final when events are added, not when sealing
+    REQUIRE(base.event("changed").ordinal() == 0);
+    REQUIRE(derived.event("renamed").ordinal() == 1);
+
+    OrdinalEmitter emitter;
+    std::string renamed;
+    int changed = 0;
+    emitter.subscribe("renamed", [&renamed](std::string name) { renamed = std::move(name); });
+
+    base.seal();
+    derived.seal();
+    REQUIRE(derived.event("renamed").ordinal() == 1);
+
+    // Emitting the inherited event does not reach the handler subscribed to the own event before sealing
+    emitter.event("changed", 42);
+    REQUIRE(renamed.empty());
+
+    emitter.subscribe("changed", [&changed](int value) { changed = value; });
+    emitter.event("changed", 42);
+    emitter.event("renamed", std::string("emitter"));
+    REQUIRE(changed == 42);
+    REQUIRE(renamed == "emitter");
+
+    // Events added to a base after those of a derived type would share ordinals with them
+    MetaObject late("OrdinalLate", typeid(Reflectable));
+    MetaObject lateDerived("OrdinalLateDerived", typeid(OrdinalEmitter), {&late});
+    lateDerived.addEvent<int>("first");
+    late.addEvent<int>("second");
+    late.seal();
+    REQUIRE_THROWS_AS(lateDerived.seal(), registration_failed);
+}
+
+TEST_CASE("Event Handle Ownership")
+{
+    MetaObject base("HandleBase", typeid(Reflectable));
+    MetaObject derived("HandleDerived", typeid(OrdinalEmitter), {&base});
+    MetaObject other("HandleOther", typeid(Reflectable));
+    base.addEvent<int>("changed");
+    derived.addEvent<int>("moved");
+    other.addEvent<int>("a");
+    other.addEvent<int>("b");
+    other.addEvent<int>("c");
+    base.seal();
+    derived.seal();
+    other.seal();
+    OrdinalEmitter::type = &derived;
+
+    OrdinalEmitter emitter;
+    int changed = 0;
+    int moved = 0;
+    emitter.subscribe("changed", [&changed](int value) { changed = value; });
+    emitter.subscribe("moved", [&moved](int value) { moved = value; });
+
+    // Handles of a first base and those of the event itself are valid on the derived type
+    emitter.event(base.eventHandle<int>("changed"), 1);
+    emitter.event(derived.event("moved").handle<int>(), 2);
+    REQUIRE(changed == 1);
+    REQUIRE(moved == 2);
+
+    // A handle of an unrelated type would index subscriptions of a different event
+    REQUIRE_THROWS_AS(emitter.event(other.eventHandle<int>("b"), 3), unknown_event);
+    REQUIRE_THROWS_AS(emitter.event(other.event("a").handle<int>(), 3), unknown_event);
+    REQUIRE(changed == 1);
+    REQUIRE(moved == 2);
+}
+
+TEST_CASE("Concurrent Symbol Lookup")
+{
+    // Enough symbols to grow the table while other threads look them up
+    constexpr int count = 2000;
+    std::vector<std::string> names;
+    for (int i = 0; i < count; ++i)
+        names.push_back("concurrent_symbol_" + std::to_string(i));
+
+    std::atomic<bool> mismatch = false;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&names, &mismatch, t] {
+            for (int i = t; i < count; i += 2)
+            {
+                const auto symbol = Symbol::intern(names[i]);
+                if (symbol.name() != names[i] || Symbol::find(names[i]) != symbol)
+                    mismatch = true;
+                if (auto other = Symbol::find(names[count - 1 - i]); other && other.name() != names[count - 1 - i])
+                    mismatch = true;
+            }
+        });
+
+    for (auto &thread : threads)
+        thread.join();
+
+    REQUIRE_FALSE(mismatch);
+    for (const auto &name : names)
+        REQUIRE(Symbol::find(name).name() == name);
+}
+
+namespace
+{
+    struct ClonedCounter : Counter
+    {
+        std::string label = "a label too long for the small string buffer";
+
+        Reflectable *clone() const override { return new ClonedCounter(*this); }
+
+    protected:
+        const Copier &copier() const override { return copierOf<ClonedCounter>(); }
+    };
+
+    struct SlicedCounter : Counter
+    {
+        Reflectable *clone() const override { return new SlicedCounter(*this); }
+    };
+
+    // Tracks the bytes outstanding, to check that clones are given back with the size they were allocated with
+    class CountingResource final : public std::pmr::memory_resource
+    {
+    public:
+        std::size_t outstanding = 0;
+
+    private:
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            outstanding += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *where, std::size_t bytes, std::size_t alignment) override
+        {
+            outstanding -= bytes;
+            std::pmr::new_delete_resource()->deallocate(where, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+    };
+}
+
+TEST_CASE("Clone Into Memory")
+{
+    CountingResource resource;
+
+    ClonedCounter original;
+    original.count = 7;
+
+    // Copies the dynamic type, also through a reference to the base
+    const Reflectable &base = original;
+    auto copy = base.cloneTo(resource);
+    REQUIRE(resource.outstanding == sizeof(ClonedCounter));
+    REQUIRE(dynamic_cast<ClonedCounter *>(copy));
+    REQUIRE(static_cast<ClonedCounter *>(copy)->count == 7);
+    REQUIRE(static_cast<ClonedCounter *>(copy)->label == original.label);
+
+    // Overriding clone() does not hide cloning into memory
+    auto second = original.cloneTo(resource);
+    REQUIRE(resource.outstanding == 2 * sizeof(ClonedCounter));
+
+    Reflectable::destroy(copy, resource);
+    Reflectable::destroy(second, resource);
+    REQUIRE(resource.outstanding == 0);
+
+    // Types that do not say how to copy themselves would be sliced
+    SlicedCounter sliced;
+    REQUIRE_THROWS_AS(sliced.cloneTo(resource), instantiation_failed);
+    REQUIRE(resource.outstanding == 0);
+
+    utility::arena arena;
+    REQUIRE(static_cast<ClonedCounter *>(original.cloneTo(arena))->label == original.label);
+    REQUIRE_THROWS_AS(sliced.cloneTo(arena), instantiation_failed);
+}
+
+namespace
+{
+    struct Greeter : Reflectable
+    {
+        static inline const MetaObject *type = nullptr;
+
+        std::string greeting = "hello";
+        std::vector<std::string> greeted;
+
+        const MetaObject &metaObject() const noexcept override { return *type; }
+    };
+}
+
+TEST_CASE("Invoke By Reference")
+{
+    MetaObject meta("Greeter", typeid(Greeter));
+    Greeter::type = &meta;
+
+    meta.addMethod("greet", std::function([](const Greeter *g, const std::string &name) -> std::string {
+        return g->greeting + " " + name;
+    }), Method::Qualifier::Immutable);
+    meta.addMethod("remember", std::function([](Greeter *g, std::string &&name, const int &times) -> void {
+        for (int i = 0; i < times; ++i)
+            g->greeted.push_back(name);
+    }), Method::Qualifier::Mutable);
+    meta.addMethod("join", std::function([](const std::string &a, const std::string &b) -> std::string {
+        return a + b;
+    }));
+
+    Greeter greeter;
+    const std::string name = "reference";
+
+    // Arguments are passed by value by name, and bind to the reference parameters of the overload
+    REQUIRE(greeter.invoke<std::string>("greet", name) == "hello reference");
+    REQUIRE(std::as_const(greeter).invoke<std::string>("greet", std::string("const")) == "hello const");
+
+    greeter.invoke("remember", std::string("twice"), 2);
+    REQUIRE(greeter.greeted == std::vector<std::string>{"twice", "twice"});
+
+    REQUIRE(meta.method("join").invoke<std::string>(std::string("a"), std::string("b")) == "ab");
+
+    auto result = greeter.tryInvoke<std::string>("greet", name);
+    REQUIRE(result);
+    REQUIRE(*result == "hello reference");
+    REQUIRE_FALSE(greeter.tryInvoke<int>("greet", name));
+
+    REQUIRE_THROWS_AS(greeter.invoke<std::string>("greet", 1), unknown_method);
+    REQUIRE_THROWS_AS(greeter.invoke<int>("greet", name), invalid_method_type);
+    REQUIRE_THROWS_AS(std::as_const(greeter).invoke("remember", std::string("const"), 1), unknown_method);
+}
+
+TEST_CASE("Reference Event Arguments")
+{
+    MetaObject meta("ReferenceEvents", typeid(OrdinalEmitter));
+    meta.addEvent<const std::string &>("named");
+    meta.addEvent<int &>("counted");
+    meta.seal();
+    OrdinalEmitter::type = &meta;
+
+    OrdinalEmitter emitter;
+    const std::string *seen = nullptr;
+    emitter.subscribe("named", [&seen](const std::string &name) { seen = &name; });
+    emitter.subscribe("counted", [](int &count) { ++count; });
+
+    // Handlers get the references passed to the handle, not copies
+    const std::string name = "a name too long for the small string buffer";
+    emitter.event(meta.eventHandle<const std::string &>("named"), name);
+    REQUIRE(seen == &name);
+
+    int count = 1;
+    emitter.event(meta.eventHandle<int &>("counted"), count);
+    REQUIRE(count == 2);
+
+    // The bus copies the arguments and passes references to its copies
+    EventBus bus;
+    emitter.setEventBus(&bus);
+    emitter.event(meta.eventHandle<const std::string &>("named"), name);
+    bus.flush();
+    REQUIRE(seen != &name);
+    emitter.event(meta.eventHandle<int &>("counted"), count);
+    bus.flush();
+    REQUIRE(count == 2);
+}
+
+TEST_CASE("Qualified Arguments")
+{
+    MetaObject meta("QualifiedArguments", typeid(OrdinalEmitter));
+    meta.addEvent<std::string>("byValue");
+    meta.addEvent<const std::string &>("byReference");
+    meta.seal();
+    OrdinalEmitter::type = &meta;
+
+    OrdinalEmitter emitter;
+    std::vector<std::string> seen;
+
+    // Handlers may take the arguments of an event with other cv- and reference qualifiers
+    emitter.subscribe("byValue", [&seen](const std::string &value) { seen.push_back(value); });
+    emitter.subscribe("byValue", [&seen](std::string &&value) { seen.push_back(std::move(value)); });
+    emitter.subscribe("byReference", [&seen](std::string value) { seen.push_back(std::move(value)); });
+    emitter.subscribe("byReference", [&seen](const std::string &value) { seen.push_back(value); });
+
+    // Every handler gets the value, also after another one took it by rvalue reference
+    emitter.event("byValue", std::string("value"));
+    emitter.event("byReference", std::string("name"));
+    emitter.event(meta.eventHandle<const std::string &>("byReference"), std::string("handle"));
+    REQUIRE(seen == std::vector<std::string>{"value", "value", "name", "name", "handle", "handle"});
+
+    // Diagnostics keep the qualifiers that tell the argument types apart
+    try
+    {
+        emitter.subscribe("byReference", [](int) {});
+        FAIL("subscribed with incompatible arguments");
+    }
+    catch (const invalid_event_type &e)
+    {
+        REQUIRE(std::string(e.what()).find(utility::typeName<const std::string &>()) != std::string::npos);
+    }
+
+    REQUIRE(utility::typeName<const int &>() == std::string(typeid(int).name()) + " const &");
+    REQUIRE(utility::typeName<int &&>() == std::string(typeid(int).name()) + " &&");
+
+    struct Labelled
+    {
+        explicit Labelled(const std::string &label, const int &size) : label(label + std::to_string(size)) {}
+
+        std::string label;
+    };
+
+    MetaObject labelled("QualifiedConstructor", typeid(Labelled));
+    labelled.addConstructor<Labelled, const std::string &, const int &>();
+    labelled.addConstructor([](std::string &&label) { return new Labelled(label, 0); });
+
+    // Constructors taking references are found by the arguments passed by value
+    std::unique_ptr<Labelled> created(labelled.instantiate<Labelled>(std::string("heap"), 1));
+    REQUIRE(created->label == "heap1");
+    created.reset(labelled.instantiate<Labelled>(std::string("moved")));
+    REQUIRE(created->label == "moved0");
+
+    utility::arena arena;
+    REQUIRE(labelled.construct<Labelled>(arena, std::string("arena"), 2)->label == "arena2");
+    REQUIRE_THROWS_AS(labelled.instantiate<Labelled>(1, 2), unknown_constructor);
+}